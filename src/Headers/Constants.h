@@ -12,10 +12,53 @@ namespace Constants
     // -- Thread Base
     constexpr inline int heartbeatIntervalMs = 500;
     constexpr inline int tickIntervalMs = 1;
+    constexpr inline size_t maxTrackedCpus = 256;
 
     // -- processing thread --
     constexpr inline size_t maxQueueSize = 20;
     constexpr inline bool blockingPush = true;
+    constexpr inline size_t messagePoolCapacity = 4096;
+    constexpr inline size_t messageArenaInitialBytes = 64 * 1024; // CMessageBatch's first arena block; grows to the largest batch seen
+
+    // -- Clock
+    constexpr inline int clockCalibrationMs = 10; // TSC calibration window, busy-waited once at startup
+
+    // -- Concurrency
+    constexpr inline size_t cacheLineSize = 64;
+    constexpr inline int waitSpinIterations = 2048;
+    constexpr inline size_t queueDwellBuckets = 40;
+    constexpr inline unsigned latencySubBucketBits = 5; // 32 linear sub-buckets per power of two, ~3% error
+    constexpr inline unsigned latencyMaxBits = 40;      // values up to 2^40 ns (~18 min); larger ones clamp
+
+    // -- Executor
+    constexpr inline size_t executorDequeCapacity = 1024;
+    constexpr inline int executorIdleWaitMs = 100;
+
+    // -- Scheduler
+    constexpr inline uint64_t timerWheelResolutionUs = 100;
+    constexpr inline uint64_t timerSlackUs = 1000;
+    constexpr inline int schedulerMaxIdleMs = 100;
+
+    // -- Tracing
+    constexpr inline size_t traceBufferEvents = 8192;
+    constexpr inline int traceFlushIntervalMs = 100;
+
+    // -- Metrics endpoint
+    constexpr inline uint16_t metricsPort = 9464;
+    constexpr inline size_t metricsBodyReserve = 64 * 1024;
+    constexpr inline size_t metricsArenaBytes = 16 * 1024;
+
+    // -- Pipeline
+    constexpr inline size_t pipelineEdgeCapacity = 1024;
+    constexpr inline size_t pipelineBatch = 64;         // elements drained per Tick() across a stage's inputs
+    constexpr inline double pipelineSaturatedFill = 0.9; // edge fill ratio reported as saturated
+
+    // -- Ingestion
+    constexpr inline size_t ndjsonReleaseBytes = 16 * 1024 * 1024; // mapped input released to the kernel in slices of this size
+
+    // -- Message log
+    constexpr inline size_t messageLogSegmentBytes = 64 * 1024 * 1024; // CMessageLog segment file size
+    constexpr inline uint64_t messageLogIndexInterval = 64;            // records per sparse index entry in CMessageLogReader
 
     // -- Stabilization
     enum class Flavour : std::uint8_t
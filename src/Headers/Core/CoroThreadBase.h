@@ -0,0 +1,239 @@
+#pragma once
+
+#include "Core/ThreadBase.h"
+#include "Core/ThreadMetrics.h"
+#include "Core/ThreadRegistry.h"
+#include "Utils/Coroutine.h"
+#include "Utils/SeqLock.h"
+#include "Utils/ThreadConcepts.h"
+#include "Utils/ThreadPlacement.h"
+#include "Utils/Utils.h"
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+
+// Coroutine flavour of CThreadBase: Run() is an actor coroutine on a CCoroScheduler rather than a
+// dedicated std::thread, so tens of thousands of them cost their frames and metrics only. Metrics
+// and registration match CThreadBase; a tick is the work between two Receive() calls, and the
+// heartbeat is taken at tick boundaries since an idle actor does not run. Tick and dwell latencies
+// go to the scheduler's per-worker histograms. Placement fields in ThreadProperties do not apply.
+// Derived classes call Stop() in their own destructor: the suspended frame refers to their members,
+// which are gone by the time the base destructor runs.
+//     class CSymbolActor : public CCoroThreadBase<>
+//     {
+//         ~CSymbolActor() override { Stop(); }
+//         CActorTask Run() override
+//         {
+//             while (std::optional<Message> message = co_await Receive(m_inbox)) { ... }
+//         }
+//         CAsyncQueue<Message> m_inbox;
+//     };
+template<typename T = ThreadProperties, typename U = decltype(T::m_metrics)>
+requires ThreadCompatible<T, U, ThreadProperties, ThreadMetrics>
+class CCoroThreadBase
+{
+public:
+    explicit CCoroThreadBase(const T& properties)
+        : m_properties(properties)
+    {
+        m_published.Store(m_properties.m_metrics);
+        CThreadRegistry::Instance().Register(this, m_uuid, m_properties.m_name, [this] { return static_cast<ThreadMetrics>(m_published.Load()); });
+    }
+
+    CCoroThreadBase() = delete;
+    CCoroThreadBase(const CCoroThreadBase&) = delete;
+    CCoroThreadBase(CCoroThreadBase&&) = delete;
+    CCoroThreadBase& operator=(const CCoroThreadBase&) = delete;
+    CCoroThreadBase& operator=(CCoroThreadBase&&) = delete;
+
+    virtual ~CCoroThreadBase()
+    {
+        Stop();
+        CThreadRegistry::Instance().Unregister(this);
+    }
+
+    bool Start(CCoroScheduler& scheduler)
+    {
+        if (m_isRunning.exchange(true))
+        {
+            return false;
+        }
+        m_scheduler = &scheduler;
+        scheduler.Spawn(std::move(Run().NotifyOnCompletion(m_completion, &m_isRunning)));
+        return true;
+    }
+
+    // Ends the actor and waits for Run() to return. From then on Receive() yields nullopt at once,
+    // and the queue the actor is suspended on in Receive(), if any, is closed to wake it. Other
+    // awaits (a Push() into a full queue) still complete as usual. IsRunning() also turns false when
+    // Run() returns by itself.
+    virtual void Stop()
+    {
+        m_isRunning.store(false);
+        StopHook hook;
+        {
+            std::lock_guard<std::mutex> lk(m_stopMutex);
+            hook = std::exchange(m_stopHook, {});
+        }
+        if (hook.m_close)
+        {
+            hook.m_close(hook.m_queue);
+        }
+        m_completion.Wait();
+    }
+
+    // Consistent copy of the metrics as last published by the actor. Safe from any thread.
+    [[nodiscard]] U Snapshot() const { return m_published.Load(); }
+    [[nodiscard]] virtual const T& GetProperties() const { return m_properties; }
+    [[nodiscard]] virtual bool IsRunning() const { return m_isRunning.load(); }
+    [[nodiscard]] virtual const std::string& GetUUID() const { return m_uuid; }
+
+protected:
+    virtual CActorTask Run() = 0;
+
+    // Working copy, updated in place by the actor: read it from Run(). Other threads use Snapshot().
+    [[nodiscard]] virtual const U& GetMetrics() const { return m_properties.m_metrics; }
+
+    // Closes the queue an actor is suspended on in Receive(), so Stop() can wake it.
+    struct StopHook
+    {
+        void* m_queue{nullptr};
+        void (*m_close)(void*){nullptr};
+    };
+
+    // Returning without awaiting the inner Pop() leaves its value empty, so the actor sees nullopt.
+    template<typename Inner>
+    class ReceiveAwaiter
+    {
+    public:
+        ReceiveAwaiter(CCoroThreadBase& owner, Inner inner, StopHook hook)
+            : m_owner(owner)
+            , m_inner(std::move(inner))
+            , m_hook(hook)
+        {
+        }
+
+        bool await_ready()
+        {
+            m_owner.EndTick();
+            return !m_owner.m_isRunning.load() || m_inner.await_ready();
+        }
+
+        // The hook goes in before the running check, both under m_stopMutex: either Stop() finds the
+        // hook and closes the queue, or this sees the flag cleared and does not suspend.
+        template<typename Promise>
+        bool await_suspend(std::coroutine_handle<Promise> handle)
+        {
+            {
+                std::lock_guard<std::mutex> lk(m_owner.m_stopMutex);
+                if (!m_owner.m_isRunning.load())
+                {
+                    return false;
+                }
+                m_owner.m_stopHook = m_hook;
+            }
+            return m_inner.await_suspend(handle);
+        }
+
+        auto await_resume()
+        {
+            {
+                std::lock_guard<std::mutex> lk(m_owner.m_stopMutex);
+                m_owner.m_stopHook = {};
+            }
+            auto item = m_inner.await_resume();
+            m_owner.BeginTick();
+            if (item)
+            {
+                m_owner.RecordDwell(*item);
+            }
+            return item;
+        }
+
+    private:
+        CCoroThreadBase& m_owner;
+        Inner m_inner;
+        StopHook m_hook;
+    };
+
+    // co_await Receive(queue): queue.Pop() that closes the current tick before suspending, opens the
+    // next one on resume and records the element's dwell time. nullopt once Stop() was called.
+    template<typename Queue>
+    ReceiveAwaiter<typename Queue::PopAwaiter> Receive(Queue& queue)
+    {
+        return {*this, queue.Pop(), {&queue, [](void* target) { static_cast<Queue*>(target)->Close(); }}};
+    }
+
+    template<typename MessageT>
+    void RecordDwell(const MessageT& message)
+    {
+        if constexpr (requires { message->m_timestamp; })
+        {
+            if (message)
+            {
+                RecordDwell(*message);
+            }
+        }
+        else if constexpr (requires { message.m_timestamp; })
+        {
+            if (message.m_timestamp != 0 && m_scheduler)
+            {
+                uint64_t const now = Utils::GetTickCountNanos();
+                m_scheduler->RecordDwell(now > message.m_timestamp ? now - message.m_timestamp : 0);
+            }
+        }
+    }
+
+    virtual void SendHeartbeat()
+    {
+        uint64_t now = Utils::GetTickCountMillis();
+        if (now - m_properties.m_metrics.m_lastHeartbeatEpochMS >= m_properties.m_heartbeatIntervalMS)
+        {
+            OnHeartbeat();
+            return;
+        }
+        PublishMetrics();
+    }
+
+    virtual void OnHeartbeat()
+    {
+        m_properties.m_metrics.m_lastHeartbeatEpochMS = Utils::GetTickCountMillis();
+        m_properties.m_metrics.m_cpu = Utils::GetCurrentCpu();
+        PublishMetrics();
+    }
+
+    // Only the actor writes the working copy; it may resume on any worker, one at a time.
+    void PublishMetrics() { m_published.Store(m_properties.m_metrics); }
+
+    std::atomic<bool> m_isRunning{false};
+    std::string m_uuid{Utils::GenerateUUID()};
+    T m_properties{};
+    CCoroScheduler* m_scheduler{nullptr};
+
+private:
+    void BeginTick() { m_tickStartNs = Utils::GetTickCountNanos(); }
+
+    void EndTick()
+    {
+        if (m_tickStartNs == 0)
+        {
+            return;
+        }
+        uint64_t const end = Utils::GetTickCountNanos();
+        m_scheduler->RecordTick(end - m_tickStartNs);
+        m_tickStartNs = 0;
+        ++m_properties.m_metrics.m_tickCount;
+        SendHeartbeat();
+    }
+
+    CSeqLock<U> m_published;
+    CCoroCompletion m_completion;
+    std::mutex m_stopMutex;
+    StopHook m_stopHook;
+    uint64_t m_tickStartNs{0};
+};
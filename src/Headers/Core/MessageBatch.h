@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Constants.h"
+#include "Core/MessageData.h"
+#include "Utils/CountingResource.h"
+
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <vector>
+
+// A batch of ArenaMessages created together and freed together. The messages and every payload node
+// (strings, object members, array elements) come from one monotonic arena, so building a batch is
+// pointer bumps and freeing it is Reset(): no per-node destructor or free(). The arena's first block
+// is kept across batches and grows to the largest batch seen, so a steady stream of similar batches
+// stops touching the system allocator altogether.
+//     CMessageBatch batch;
+//     ArenaMessage& message = batch.Add();
+//     message.m_payload.try_emplace("symbol", jsoncons::pmr::json("AAPL", batch.Allocator()));
+//     ...
+//     batch.Reset();
+// Messages are never destroyed individually, so payloads must only hold memory from Allocator().
+// Single-threaded, like std::pmr::monotonic_buffer_resource.
+class CMessageBatch
+{
+public:
+    using allocator_type = ArenaMessage::allocator_type;
+
+    explicit CMessageBatch(size_t initialBytes = Constants::messageArenaInitialBytes, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~CMessageBatch();
+
+    CMessageBatch(const CMessageBatch&) = delete;
+    CMessageBatch& operator=(const CMessageBatch&) = delete;
+    CMessageBatch(CMessageBatch&&) = delete;
+    CMessageBatch& operator=(CMessageBatch&&) = delete;
+
+    // A new message with an empty object payload bound to the arena.
+    ArenaMessage& Add();
+
+    // Frees every message in the batch at once. References from Add() are invalidated.
+    void Reset();
+
+    [[nodiscard]] allocator_type Allocator() noexcept { return allocator_type(&*m_arena); }
+    [[nodiscard]] std::span<ArenaMessage* const> Messages() const noexcept { return m_messages; }
+    [[nodiscard]] size_t Size() const noexcept { return m_messages.size(); }
+    // What the batches cost the upstream allocator, the retained block included.
+    [[nodiscard]] const MemoryStats& Memory() const noexcept { return m_upstream.Stats(); }
+    [[nodiscard]] size_t RetainedBytes() const noexcept { return m_blockSize; }
+
+private:
+    void ReplaceBlock(size_t bytes);
+
+    CCountingResource m_upstream;
+    std::byte* m_block{nullptr};
+    size_t m_blockSize{0};
+    std::optional<std::pmr::monotonic_buffer_resource> m_arena;
+    std::vector<ArenaMessage*> m_messages;
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Core/MessageData.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+// Payload encoding inside an encoded Message. JSON is the text baseline; the binary formats are
+// jsoncons' CBOR, MessagePack and BSON encoders. BSON documents must be objects.
+enum class PayloadFormat : uint8_t
+{
+    JSON = 0,
+    CBOR = 1,
+    MSGPACK = 2,
+    BSON = 3
+};
+
+// Fixed-size prefix of an encoded Message. Readers can route, index or filter on it without
+// touching the payload.
+struct MessageHeader
+{
+    uint64_t m_timestamp{};
+    uint64_t m_id{};
+    bool m_isProcessed{false};
+    PayloadFormat m_format{PayloadFormat::CBOR};
+    uint32_t m_payloadSize{};
+};
+
+// Binary wire codec for Message. Layout, little-endian:
+//     0  u64 m_timestamp
+//     8  u64 m_id
+//    16  u8  flags (bit 0: m_isProcessed)
+//    17  u8  PayloadFormat
+//    18  u16 reserved, 0
+//    20  u32 payload size in bytes
+//    24  payload
+// The decoder reads the format from the header, so one reader accepts every format.
+//     CMessageCodec codec(PayloadFormat::CBOR);
+//     std::vector<uint8_t> wire;
+//     codec.Encode(message, wire);        // appends
+//     Message copy;
+//     CMessageCodec::Decode(wire, copy);
+class CMessageCodec
+{
+public:
+    static constexpr size_t headerSize = 24;
+
+    explicit CMessageCodec(PayloadFormat format = PayloadFormat::CBOR)
+        : m_format(format)
+    {
+    }
+
+    // Appends one encoded message to out. Returns false, leaving out as it was, if the payload cannot
+    // be encoded in this format (a non-object payload in BSON).
+    bool Encode(const Message& message, std::vector<uint8_t>& out) const;
+
+    // Decodes one message from the front of bytes. Returns the number of bytes consumed, or 0 if the
+    // input is truncated or malformed (out is then unspecified).
+    static size_t Decode(std::span<const uint8_t> bytes, Message& out);
+
+    // Reads the header only; nullopt if bytes is shorter than headerSize or the format is unknown.
+    [[nodiscard]] static std::optional<MessageHeader> PeekHeader(std::span<const uint8_t> bytes) noexcept;
+
+    // Writes header into the first headerSize bytes of out. For codecs of other payload types
+    // (CTypedCodec, Core/TypedMessage.h) sharing this layout.
+    static void WriteHeader(const MessageHeader& header, uint8_t* out) noexcept;
+
+    [[nodiscard]] PayloadFormat Format() const noexcept { return m_format; }
+    [[nodiscard]] static const char* FormatName(PayloadFormat format) noexcept;
+
+private:
+    PayloadFormat m_format;
+};
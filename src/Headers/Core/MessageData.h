@@ -1,11 +1,29 @@
 #pragma once
 #include <cstdint>
 #include <jsoncons/json.hpp>
+#include <memory_resource>
 
 struct Message
 {
-    uint64_t m_timestamp{};
+    uint64_t m_timestamp{}; // Utils::GetTickCountNanos() when enqueued; 0 if unstamped
     uint64_t m_id{};
     jsoncons::json m_payload;
     bool m_isProcessed{false};
 };
+
+// Message whose payload allocates from a per-batch arena instead of the global heap; created by
+// CMessageBatch (Core/MessageBatch.h) and freed with the whole batch.
+struct ArenaMessage
+{
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    explicit ArenaMessage(const allocator_type& alloc)
+        : m_payload(jsoncons::json_object_arg, jsoncons::semantic_tag::none, alloc)
+    {
+    }
+
+    uint64_t m_timestamp{}; // Utils::GetTickCountNanos() when enqueued; 0 if unstamped
+    uint64_t m_id{};
+    jsoncons::pmr::json m_payload;
+    bool m_isProcessed{false};
+};
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "Constants.h"
+#include "Core/MessageCodec.h"
+#include "Core/MessageData.h"
+#include "Utils/Clock.h"
+#include "Utils/MappedFile.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Durable capture of Messages: a directory of fixed-size segment files, each memory-mapped and filled
+// front to back with records, then rolled over to the next. Layout, little-endian:
+//     segment file   <first record number, 20 digits>.twlog
+//      0  u64 magic "TWIZLOG1"
+//      8  u32 version
+//     12  u32 reserved, 0
+//     16  u64 first record number
+//     24  u64 reserved, 0
+//     32  records
+//     record
+//      0  u32 length of the encoded message
+//      4  u32 FNV-1a checksum of the encoded message
+//      8  CMessageCodec encoding (24-byte header, payload)
+//         zero padding to 8 bytes
+// A zero length ends a segment. Segments are created full-size and sparse, so unwritten space reads as
+// zero. The length is written last, and recovery (Open() on an existing log) zeroes everything from the
+// first record whose length, checksum or header does not hold, so a crash mid-append loses at most the
+// records being written. Records store m_timestamp as wall time (Utils::TickNanosToEpochNanos), so a
+// log appended to across reboots still reads in time order.
+//     CMessageLog log("capture");
+//     log.Open();
+//     log.Append(message);
+//     log.Flush();
+// Single writer; read with CMessageLogReader.
+class CMessageLog
+{
+public:
+    static constexpr size_t segmentHeaderSize = 32;
+    static constexpr size_t recordPrefixSize = 8;
+
+    explicit CMessageLog(std::filesystem::path directory, size_t segmentBytes = Constants::messageLogSegmentBytes, PayloadFormat format = PayloadFormat::CBOR);
+    ~CMessageLog() { Close(); }
+
+    CMessageLog(const CMessageLog&) = delete;
+    CMessageLog& operator=(const CMessageLog&) = delete;
+    CMessageLog(CMessageLog&&) = delete;
+    CMessageLog& operator=(CMessageLog&&) = delete;
+
+    // Creates the directory, or reopens the log in it and recovers its tail. Appends continue after the
+    // last intact record. Existing segments keep their size.
+    bool Open();
+    void Close();
+
+    // False if the log is not open, the payload cannot be encoded, or the record exceeds a segment.
+    bool Append(const Message& message);
+
+    // Starts writing the current segment back to disk; wait blocks until it is there. Records survive a
+    // crash of the process without it.
+    bool Flush(bool wait = false);
+
+    [[nodiscard]] uint64_t RecordCount() const noexcept { return m_recordCount; }
+    [[nodiscard]] size_t SegmentCount() const noexcept { return m_segmentCount; }
+    // Bytes of torn records zeroed by the last Open().
+    [[nodiscard]] size_t RecoveredBytes() const noexcept { return m_recoveredBytes; }
+    [[nodiscard]] const std::filesystem::path& SegmentPath() const noexcept { return m_segmentPath; }
+    // Where the next record goes in the current segment.
+    [[nodiscard]] size_t WriteOffset() const noexcept { return m_writeOffset; }
+
+    // Length of the intact record at offset in a segment, padding included, or 0 at the end.
+    [[nodiscard]] static size_t ScanRecord(std::span<const uint8_t> segment, size_t offset) noexcept;
+
+private:
+    bool CreateSegment(uint64_t firstRecord);
+    bool Recover(const std::filesystem::path& path, uint64_t firstRecord);
+
+    std::filesystem::path m_directory;
+    size_t m_segmentBytes;
+    CMessageCodec m_codec;
+    CMappedFile m_segment;
+    std::filesystem::path m_segmentPath;
+    size_t m_writeOffset{0};
+    uint64_t m_recordCount{0};
+    size_t m_segmentCount{0};
+    size_t m_recoveredBytes{0};
+    std::vector<uint8_t> m_scratch;
+};
+
+// One record as stored; m_bytes views the mapping (the CMessageCodec encoding, header included) and
+// stays valid while the reader is open. m_header.m_timestamp is wall time in nanoseconds.
+struct LogRecord
+{
+    MessageHeader m_header;
+    std::span<const uint8_t> m_bytes;
+    uint64_t m_record{};
+};
+
+struct LogIndexEntry
+{
+    uint64_t m_timestamp{};
+    uint64_t m_id{};
+    uint64_t m_record{};
+    size_t m_segment{};
+    size_t m_offset{};
+};
+
+struct ReplayOptions
+{
+    double m_speed{1.0};                                          // 1 keeps the recorded gaps, 2 halves them; 0 or less replays flat out
+    uint64_t m_endTimestamp{std::numeric_limits<uint64_t>::max()}; // wall time; stops before the first record stamped at or after it
+    bool m_restamp{true};                                         // stamp Messages when pushed, as live producers do; otherwise map the recorded wall time back to ticks
+};
+
+// Reads a CMessageLog directory through read-only mappings. Open() walks every record once, checking
+// it and keeping an index entry every Constants::messageLogIndexInterval records; the seeks then
+// binary search that sparse index and scan at most one interval, so they are O(log n). Open() also
+// checks that m_timestamp and m_id never decrease along the log; a seek on a key that does scans from
+// the front instead.
+//     CMessageLogReader reader("capture");
+//     reader.Open();
+//     reader.SeekTimestamp(from);
+//     reader.Replay(queue, {.m_speed = 4.0});
+// Records appended after Open() are not seen. Single-threaded.
+class CMessageLogReader
+{
+public:
+    explicit CMessageLogReader(std::filesystem::path directory);
+
+    bool Open();
+    void Close();
+
+    // The record at the read position, without copying or decoding its payload; then moves past it.
+    bool Next(LogRecord& out);
+
+    // Positions at the first record with m_timestamp (wall time, see Utils::GetEpochNanos) or m_id at or
+    // after the argument. False, and at the end, if there is none.
+    bool SeekTimestamp(uint64_t timestamp);
+    bool SeekId(uint64_t id);
+    void Rewind() noexcept;
+
+    // Decodes records from the read position into queue, paced by their recorded timestamps. Stops at
+    // the end of the log, at options.m_endTimestamp, or when the queue is closed. Returns the number
+    // pushed. Pacing sleeps, so its precision is the scheduler's (tens of microseconds).
+    template<typename Queue>
+    size_t Replay(Queue& queue, const ReplayOptions& options = {})
+    {
+        LogRecord record;
+        Message message;
+        size_t pushed = 0;
+        bool const paced = options.m_speed > 0.0;
+        uint64_t firstTimestamp = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (Peek(record) && record.m_header.m_timestamp < options.m_endTimestamp)
+        {
+            Advance(record);
+            if (CMessageCodec::Decode(record.m_bytes, message) == 0)
+            {
+                continue;
+            }
+            if (paced)
+            {
+                if (pushed == 0)
+                {
+                    firstTimestamp = message.m_timestamp;
+                    start = std::chrono::steady_clock::now();
+                }
+                uint64_t const gap = message.m_timestamp > firstTimestamp ? message.m_timestamp - firstTimestamp : 0;
+                std::this_thread::sleep_until(start + std::chrono::nanoseconds(static_cast<int64_t>(static_cast<double>(gap) / options.m_speed)));
+            }
+            message.m_timestamp = options.m_restamp ? Utils::GetTickCountNanos() : Utils::EpochNanosToTickNanos(message.m_timestamp);
+            if (!queue.Push(std::move(message)))
+            {
+                break;
+            }
+            ++pushed;
+        }
+        return pushed;
+    }
+
+    [[nodiscard]] uint64_t RecordCount() const noexcept { return m_recordCount; }
+    [[nodiscard]] size_t SegmentCount() const noexcept { return m_segments.size(); }
+    [[nodiscard]] const std::vector<LogIndexEntry>& Index() const noexcept { return m_index; }
+
+private:
+    struct Segment
+    {
+        std::unique_ptr<CMappedFile> m_file;
+        uint64_t m_firstRecord{};
+        size_t m_end{}; // offset past the last intact record
+    };
+
+    // The record at the read position, skipping to the next segment at the end of one.
+    bool Peek(LogRecord& out);
+    void Advance(const LogRecord& record) noexcept;
+
+    template<typename Key>
+    bool Seek(uint64_t target, bool ordered, Key key);
+
+    std::filesystem::path m_directory;
+    std::vector<Segment> m_segments;
+    std::vector<LogIndexEntry> m_index;
+    uint64_t m_recordCount{0};
+    bool m_timestampsOrdered{true};
+    bool m_idsOrdered{true};
+    size_t m_segment{0};
+    size_t m_offset{CMessageLog::segmentHeaderSize};
+    uint64_t m_record{0};
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Constants.h"
+#include "Core/MessageData.h"
+#include "Utils/MpmcQueue.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+struct MessagePoolMetrics
+{
+    uint64_t m_hits{};
+    uint64_t m_misses{};
+    uint64_t m_recycled{};
+    uint64_t m_discarded{};
+    uint64_t m_available{};
+    uint64_t m_outstanding{};
+
+    [[nodiscard]] double HitRate() const noexcept
+    {
+        uint64_t const total = m_hits + m_misses;
+        return total ? static_cast<double>(m_hits) / static_cast<double>(total) : 0.0;
+    }
+};
+
+// Recycling pool for Message objects. Acquire() hands out an RAII handle; destroying the handle resets
+// the Message and returns it to a lock-free free list, keeping the payload's object/array storage so
+// the next producer refills it without reallocating. Handles move through CQueue like any value:
+//     CQueue<CMessagePool::Handle, MpmcRing> q(1024);
+// The pool must outlive every handle it issued. CMetricsRegistry::RegisterPool() exports the metrics.
+class CMessagePool
+{
+public:
+    struct Deleter
+    {
+        CMessagePool* m_pool{nullptr};
+        void operator()(Message* message) const noexcept;
+    };
+    using Handle = std::unique_ptr<Message, Deleter>;
+
+    explicit CMessagePool(size_t capacity = Constants::messagePoolCapacity, size_t prefill = 0);
+    ~CMessagePool();
+
+    CMessagePool(const CMessagePool&) = delete;
+    CMessagePool& operator=(const CMessagePool&) = delete;
+    CMessagePool(CMessagePool&&) = delete;
+    CMessagePool& operator=(CMessagePool&&) = delete;
+
+    [[nodiscard]] Handle Acquire();
+    [[nodiscard]] MessagePoolMetrics GetMetrics() const noexcept;
+    [[nodiscard]] size_t Capacity() const noexcept { return m_free.Capacity(); }
+
+private:
+    void Release(Message* message) noexcept;
+    static void Reset(Message& message) noexcept;
+
+    CQueue<Message*, MpmcRing> m_free;
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+    std::atomic<uint64_t> m_recycled{0};
+    std::atomic<uint64_t> m_discarded{0};
+    std::atomic<uint64_t> m_outstanding{0};
+};
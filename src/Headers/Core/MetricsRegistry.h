@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Core/MessagePool.h"
+#include "Utils/LatencyHistogram.h"
+#include "Utils/QueueMetrics.h"
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Named CQueues, CMessagePools and standalone histograms exposed to the metrics endpoint. Threads are listed by
+// CThreadRegistry instead. Owners register what they want exported and must unregister it before
+// it is destroyed; readers only take snapshots, so a scrape never blocks the owner.
+//     CQueue<Message, MpmcRing, ParkWait, CQueueMetrics> ingest(1024);
+//     CMetricsRegistry::Instance().RegisterQueue(ingest, "ingest");
+class CMetricsRegistry
+{
+public:
+    using QueueSnapshotFn = std::function<QueueMetricsSnapshot()>;
+    using QueueSizeFn = std::function<size_t()>;
+    using PoolSnapshotFn = std::function<MessagePoolMetrics()>;
+
+    static CMetricsRegistry& Instance();
+
+    CMetricsRegistry(const CMetricsRegistry&) = delete;
+    CMetricsRegistry& operator=(const CMetricsRegistry&) = delete;
+    CMetricsRegistry(CMetricsRegistry&&) = delete;
+    CMetricsRegistry& operator=(CMetricsRegistry&&) = delete;
+
+    // Counters are all zero unless the queue's Metrics parameter is CQueueMetrics; size is always live.
+    // Both are read without the queue's lock: the default backend's size comes from ApproxSize().
+    template<typename Queue>
+    void RegisterQueue(const Queue& queue, std::string name)
+    {
+        RegisterQueue(&queue, std::move(name), [&queue] { return queue.GetMetrics().Snapshot(); }, [&queue] {
+            if constexpr (requires { queue.ApproxSize(); })
+            {
+                return static_cast<size_t>(queue.ApproxSize());
+            }
+            else
+            {
+                return static_cast<size_t>(queue.Size());
+            }
+        });
+    }
+
+    void RegisterQueue(const void* owner, std::string name, QueueSnapshotFn snapshot, QueueSizeFn size);
+
+    // Hits, misses and free-list size; GetMetrics() reads atomics only.
+    void RegisterPool(const CMessagePool& pool, std::string name)
+    {
+        RegisterPool(&pool, std::move(name), [&pool] { return pool.GetMetrics(); });
+    }
+
+    void RegisterPool(const void* owner, std::string name, PoolSnapshotFn snapshot);
+    void RegisterHistogram(const CLatencyHistogram& histogram, std::string name);
+    // Removes every queue, pool and histogram registered under owner (its address).
+    void Unregister(const void* owner);
+
+    // fn(name, snapshot, size)
+    template<typename Fn>
+    void ForEachQueue(Fn&& fn) const
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        for (const QueueEntry& entry : m_queues)
+        {
+            fn(entry.m_name, entry.m_snapshot(), entry.m_size());
+        }
+    }
+
+    // fn(name, metrics)
+    template<typename Fn>
+    void ForEachPool(Fn&& fn) const
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        for (const PoolEntry& entry : m_pools)
+        {
+            fn(entry.m_name, entry.m_snapshot());
+        }
+    }
+
+    // fn(name, histogram)
+    template<typename Fn>
+    void ForEachHistogram(Fn&& fn) const
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        for (const HistogramEntry& entry : m_histograms)
+        {
+            fn(entry.m_name, *entry.m_histogram);
+        }
+    }
+
+private:
+    CMetricsRegistry() = default;
+
+    struct QueueEntry
+    {
+        const void* m_owner;
+        std::string m_name;
+        QueueSnapshotFn m_snapshot;
+        QueueSizeFn m_size;
+    };
+
+    struct PoolEntry
+    {
+        const void* m_owner;
+        std::string m_name;
+        PoolSnapshotFn m_snapshot;
+    };
+
+    struct HistogramEntry
+    {
+        std::string m_name;
+        const CLatencyHistogram* m_histogram;
+    };
+
+    mutable std::mutex m_mutex;
+    std::vector<QueueEntry> m_queues;
+    std::vector<PoolEntry> m_pools;
+    std::vector<HistogramEntry> m_histograms;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Constants.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+// Prometheus scrape endpoint: GET /metrics renders CThreadRegistry and CMetricsRegistry through
+// CPrometheusWriter. Runs its own io_context on one dedicated thread, so a scrape never runs on or
+// blocks a worker. Each keep-alive connection reuses its read buffer, body and header arena, so
+// repeated scrapes of a stable set of threads and queues do not allocate.
+//     CMetricsServer server;          // 0.0.0.0:Constants::metricsPort
+//     server.Start();
+class CMetricsServer
+{
+public:
+    explicit CMetricsServer(uint16_t port = Constants::metricsPort, std::string address = "0.0.0.0");
+    ~CMetricsServer();
+
+    CMetricsServer(const CMetricsServer&) = delete;
+    CMetricsServer& operator=(const CMetricsServer&) = delete;
+    CMetricsServer(CMetricsServer&&) = delete;
+    CMetricsServer& operator=(CMetricsServer&&) = delete;
+
+    // Binds and starts serving; false if the address could not be bound.
+    bool Start();
+    // Closes the listener and every open connection, then joins the server thread.
+    void Stop();
+
+    // Bound port once started (useful with port 0).
+    [[nodiscard]] uint16_t Port() const noexcept { return m_boundPort.load(std::memory_order_acquire); }
+    [[nodiscard]] bool IsRunning() const noexcept { return m_isRunning.load(std::memory_order_acquire); }
+
+private:
+    struct State;
+
+    std::string m_address;
+    uint16_t m_port;
+    std::atomic<uint16_t> m_boundPort{0};
+    std::atomic<bool> m_isRunning{false};
+    std::unique_ptr<State> m_state;
+    std::thread m_thread;
+};
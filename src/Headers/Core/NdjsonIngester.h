@@ -0,0 +1,135 @@
+#pragma once
+
+#include "Constants.h"
+#include "Core/MessageData.h"
+#include "Utils/Clock.h"
+#include "Utils/MappedFile.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_cursor.hpp>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+struct NdjsonOptions
+{
+    // Top-level members kept in the payload; empty keeps whole lines. Other members are skipped by the
+    // pull parser without building anything for them.
+    std::vector<std::string> m_fields;
+    // Integer member copied to m_id (it stays in the payload only if projected). Empty, or a line
+    // without it, numbers messages in input order.
+    std::string m_idField;
+};
+
+struct NdjsonStats
+{
+    uint64_t m_lines{};     // non-blank lines seen
+    uint64_t m_messages{};  // pushed into the queue
+    uint64_t m_malformed{}; // not valid JSON, or not an object under a projection
+    uint64_t m_bytes{};     // input consumed
+};
+
+// Streams newline-delimited JSON into a bounded CQueue as Messages. Each line goes through jsoncons'
+// pull cursor (staj events), and only the projected members are turned into json values; unwanted
+// subtrees are parsed past without allocating. Push() blocks while the queue is full, so memory is
+// bounded by the queue capacity, not the input size. Files are memory-mapped and the pages already
+// ingested handed back as it goes, so a file larger than memory streams at a bounded resident size.
+//     CQueue<Message, MpmcRing> queue(Constants::maxQueueSize);
+//     CNdjsonIngester ingester({.m_fields = {"symbol", "bid", "ask"}, .m_idField = "seq"});
+//     ingester.IngestFile("quotes.ndjson", queue);
+// A line that fails to parse is counted and skipped. Messages are stamped with
+// Utils::GetTickCountNanos() as they are pushed. One ingester per thread.
+class CNdjsonIngester
+{
+public:
+    explicit CNdjsonIngester(NdjsonOptions options = {});
+
+    // Ingests every complete line of text. Returns false if the queue was closed before the end.
+    template<typename Queue>
+    bool Ingest(std::string_view text, Queue& queue)
+    {
+        size_t begin = 0;
+        while (begin < text.size())
+        {
+            size_t end = text.find('\n', begin);
+            if (end == std::string_view::npos)
+            {
+                end = text.size();
+            }
+            std::string_view const line = text.substr(begin, end - begin);
+            begin = std::min(end + 1, text.size());
+            m_stats.m_bytes += line.size() + (end < text.size() ? 1 : 0);
+
+            Message message;
+            if (!ParseLine(line, message))
+            {
+                continue;
+            }
+            message.m_timestamp = Utils::GetTickCountNanos();
+            if (!queue.Push(std::move(message)))
+            {
+                return false;
+            }
+            ++m_stats.m_messages;
+        }
+        return true;
+    }
+
+    // Maps path and ingests it in Constants::ndjsonReleaseBytes slices, releasing each slice's pages
+    // once its messages are queued. Returns false if the file cannot be opened or the queue closed.
+    template<typename Queue>
+    bool IngestFile(const std::string& path, Queue& queue)
+    {
+        CMappedFile file;
+        if (!file.Open(path))
+        {
+            return false;
+        }
+        std::string_view const text = file.Text();
+        size_t begin = 0;
+        while (begin < text.size())
+        {
+            // Slices end on a line boundary so no line is split between them.
+            size_t end = std::min(begin + Constants::ndjsonReleaseBytes, text.size());
+            if (end < text.size())
+            {
+                size_t const newline = text.find('\n', end);
+                end = newline == std::string_view::npos ? text.size() : newline + 1;
+            }
+            bool const open = Ingest(text.substr(begin, end - begin), queue);
+            file.Release(end);
+            if (!open)
+            {
+                return false;
+            }
+            begin = end;
+        }
+        return true;
+    }
+
+    // Parses one line into out's payload and id. False for blank or malformed lines (the latter are
+    // counted).
+    bool ParseLine(std::string_view line, Message& out);
+
+    [[nodiscard]] const NdjsonStats& Stats() const noexcept { return m_stats; }
+    [[nodiscard]] const NdjsonOptions& Options() const noexcept { return m_options; }
+
+private:
+    bool ParseMembers(Message& out);
+    [[nodiscard]] bool IsProjected(std::string_view key) const noexcept;
+    jsoncons::json ReadValue();
+
+    NdjsonOptions m_options;
+    NdjsonStats m_stats;
+    uint64_t m_sequence{0};
+    // Reused across lines so their buffers are allocated once; the cursor is created on the first
+    // line and reset onto each following one.
+    std::optional<jsoncons::json_string_cursor> m_cursor;
+    std::optional<jsoncons::json_decoder<jsoncons::json>> m_decoder;
+    jsoncons::default_json_visitor m_skip;
+};
@@ -0,0 +1,497 @@
+#pragma once
+
+#include "Constants.h"
+#include "Core/MetricsRegistry.h"
+#include "Core/ThreadBase.h"
+#include "Utils/QueueMetrics.h"
+#include "Utils/SpscQueue.h"
+#include "Utils/WaitPolicy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Stage-graph runtime: stages are CThreadBase threads running RunScheduled(), edges are bounded SPSC
+// CQueues, and CPipeline wires them into a DAG.
+//   - Fan-out: a stage with several outputs broadcasts every element or partitions across them.
+//   - Fan-in: a stage with several inputs merges them round robin.
+//   - Backpressure: Emit() blocks while the chosen output is full, so a slow stage stalls everything
+//     upstream of it instead of growing a queue.
+//   - Shutdown: a stage exits once its inputs are closed and drained, then closes its outputs, so
+//     CPipeline::Close() only has to stop the sources.
+//     CPipeline pipeline;
+//     auto& source = pipeline.Add<CReader>(readerProps);
+//     auto& parse = pipeline.Add<CParser>(parserProps);
+//     auto& sink = pipeline.Add<CWriter>(writerProps);
+//     pipeline.Connect(source, parse);
+//     pipeline.Connect(parse, sink);
+//     pipeline.Start();
+//     ...
+//     pipeline.Close();
+enum class FanOut : uint8_t
+{
+    BROADCAST = 0, // every output gets a copy
+    PARTITION = 1  // one output per element: partition(value) % outputs, round robin without a partitioner
+};
+
+class CPipelineEdgeBase;
+
+class CPipelineStageBase : public CThreadBase<ThreadProperties, ThreadMetrics>
+{
+public:
+    explicit CPipelineStageBase(const ThreadProperties& properties)
+        : CThreadBase(properties)
+    {
+    }
+
+    [[nodiscard]] const std::string& Name() const { return m_properties.m_name; }
+
+    // Waits for Run() to end on its own (inputs drained, or source exhausted). Unlike Stop() it does
+    // not interrupt the stage.
+    void Join()
+    {
+        if (m_self.joinable())
+        {
+            m_self.join();
+        }
+    }
+
+protected:
+    void Run() override
+    {
+        RunScheduled();
+        CloseOutputs();
+    }
+
+    // Leaves RunScheduled() after the current Tick(); Run() then closes the outputs.
+    void Finish() { m_isRunning.store(false); }
+
+    virtual void CloseOutputs() = 0;
+
+    template<typename Item>
+    void RecordItemDwell(const Item& item)
+    {
+        if constexpr (requires { item.m_timestamp; } || requires { item->m_timestamp; })
+        {
+            RecordDwell(item);
+        }
+    }
+
+private:
+    friend class CPipeline;
+
+    std::vector<CPipelineEdgeBase*> m_inputEdges;
+    std::vector<CPipelineEdgeBase*> m_outputEdges;
+};
+
+class CPipelineEdgeBase
+{
+public:
+    CPipelineEdgeBase(std::string name, CPipelineStageBase& from, CPipelineStageBase& to)
+        : m_name(std::move(name))
+        , m_from(from)
+        , m_to(to)
+    {
+    }
+
+    virtual ~CPipelineEdgeBase() = default;
+
+    CPipelineEdgeBase(const CPipelineEdgeBase&) = delete;
+    CPipelineEdgeBase& operator=(const CPipelineEdgeBase&) = delete;
+    CPipelineEdgeBase(CPipelineEdgeBase&&) = delete;
+    CPipelineEdgeBase& operator=(CPipelineEdgeBase&&) = delete;
+
+    [[nodiscard]] const std::string& Name() const { return m_name; }
+    [[nodiscard]] CPipelineStageBase& From() const { return m_from; }
+    [[nodiscard]] CPipelineStageBase& To() const { return m_to; }
+
+    // Fails pending and future pushes; the consumer still drains what is queued.
+    virtual void Close() = 0;
+    // Closed and empty: the consumer will never see another element from this edge.
+    [[nodiscard]] virtual bool Drained() const = 0;
+    [[nodiscard]] virtual size_t Size() const = 0;
+    [[nodiscard]] virtual size_t Capacity() const = 0;
+    [[nodiscard]] virtual QueueMetricsSnapshot Snapshot() const = 0;
+
+protected:
+    std::string m_name;
+    CPipelineStageBase& m_from;
+    CPipelineStageBase& m_to;
+    std::atomic<bool> m_closed{false};
+};
+
+// One producer stage, one consumer stage. Registered with CMetricsRegistry under its name.
+template<typename T>
+class CPipelineEdge final : public CPipelineEdgeBase
+{
+public:
+    CPipelineEdge(std::string name, CPipelineStageBase& from, CPipelineStageBase& to, size_t capacity)
+        : CPipelineEdgeBase(std::move(name), from, to)
+        , m_queue(capacity)
+    {
+        CMetricsRegistry::Instance().RegisterQueue(m_queue, m_name);
+    }
+
+    ~CPipelineEdge() override { CMetricsRegistry::Instance().Unregister(&m_queue); }
+
+    // Producer stage only. Blocks while full; false once closed.
+    template<typename U>
+    bool Push(U&& value)
+    {
+        if (!m_queue.Push(std::forward<U>(value)))
+        {
+            return false;
+        }
+        m_to.Wake();
+        return true;
+    }
+
+    // Consumer stage only.
+    bool TryPop(T& out) { return m_queue.TryPopValue(out); }
+
+    void Close() override
+    {
+        m_closed.store(true, std::memory_order_release);
+        m_queue.Close();
+        m_to.Wake();
+    }
+
+    [[nodiscard]] bool Drained() const override { return m_closed.load(std::memory_order_acquire) && m_queue.Empty(); }
+    [[nodiscard]] bool HasItems() const { return !m_queue.Empty(); }
+    [[nodiscard]] size_t Size() const override { return m_queue.Size(); }
+    [[nodiscard]] size_t Capacity() const override { return m_queue.Capacity(); }
+    [[nodiscard]] QueueMetricsSnapshot Snapshot() const override { return m_queue.GetMetrics().Snapshot(); }
+
+private:
+    CQueue<T, SpscRing, ParkWait, CQueueMetrics> m_queue;
+};
+
+// A stage's input edges, merged round robin so no input starves another.
+template<typename In>
+class CPipelineInputs
+{
+public:
+    void Add(CPipelineEdge<In>& edge) { m_edges.push_back(&edge); }
+
+    [[nodiscard]] bool HasItems() const
+    {
+        return std::any_of(m_edges.begin(), m_edges.end(), [](const CPipelineEdge<In>* edge) { return edge->HasItems(); });
+    }
+
+    [[nodiscard]] bool Drained() const
+    {
+        return std::all_of(m_edges.begin(), m_edges.end(), [](const CPipelineEdge<In>* edge) { return edge->Drained(); });
+    }
+
+    // Pops up to maxCount elements, one per input in turn, and hands each to fn. In must be default
+    // constructible.
+    template<typename Fn>
+    size_t Drain(size_t maxCount, Fn&& fn)
+    {
+        size_t count = 0;
+        size_t idle = 0;
+        In item{};
+        while (count < maxCount && idle < m_edges.size())
+        {
+            CPipelineEdge<In>* edge = m_edges[m_next];
+            m_next = (m_next + 1) % m_edges.size();
+            if (!edge->TryPop(item))
+            {
+                ++idle;
+                continue;
+            }
+            idle = 0;
+            ++count;
+            fn(item);
+        }
+        return count;
+    }
+
+private:
+    std::vector<CPipelineEdge<In>*> m_edges;
+    size_t m_next{0};
+};
+
+// Base for stages with outputs.
+template<typename Out>
+class CPipelineEmitter : public CPipelineStageBase
+{
+public:
+    using output_type = Out;
+    using Partitioner = std::function<size_t(const Out&)>;
+
+    explicit CPipelineEmitter(const ThreadProperties& properties)
+        : CPipelineStageBase(properties)
+    {
+    }
+
+    // Set before CPipeline::Start().
+    void SetFanOut(FanOut mode, Partitioner partition = {})
+    {
+        m_fanOut = mode;
+        m_partition = std::move(partition);
+    }
+
+protected:
+    // Blocks while the target output is full. Returns false if the element reached no output
+    // (every target closed, or nothing connected).
+    bool Emit(const Out& value)
+    {
+        if (m_outputs.empty())
+        {
+            return false;
+        }
+        if (m_fanOut == FanOut::PARTITION)
+        {
+            return m_outputs[NextPartition(value)]->Push(value);
+        }
+        bool delivered = false;
+        for (CPipelineEdge<Out>* output : m_outputs)
+        {
+            delivered |= output->Push(value);
+        }
+        return delivered;
+    }
+
+    bool Emit(Out&& value)
+    {
+        if (m_outputs.empty())
+        {
+            return false;
+        }
+        if (m_fanOut == FanOut::PARTITION)
+        {
+            return m_outputs[NextPartition(value)]->Push(std::move(value));
+        }
+        bool delivered = false;
+        for (size_t i = 0; i + 1 < m_outputs.size(); ++i)
+        {
+            delivered |= m_outputs[i]->Push(value);
+        }
+        delivered |= m_outputs.back()->Push(std::move(value));
+        return delivered;
+    }
+
+    void CloseOutputs() override
+    {
+        for (CPipelineEdge<Out>* output : m_outputs)
+        {
+            output->Close();
+        }
+    }
+
+private:
+    friend class CPipeline;
+
+    size_t NextPartition(const Out& value)
+    {
+        if (m_partition)
+        {
+            return m_partition(value) % m_outputs.size();
+        }
+        size_t const output = m_nextOutput;
+        m_nextOutput = (m_nextOutput + 1) % m_outputs.size();
+        return output;
+    }
+
+    std::vector<CPipelineEdge<Out>*> m_outputs;
+    FanOut m_fanOut{FanOut::BROADCAST};
+    Partitioner m_partition;
+    size_t m_nextOutput{0};
+};
+
+// No inputs. Produce() runs repeatedly until it returns false or CPipeline::Close() stops the source.
+// Override HasWork() for sources that wait on something external; the default keeps ticking.
+template<typename Out>
+class CPipelineSource : public CPipelineEmitter<Out>
+{
+public:
+    explicit CPipelineSource(const ThreadProperties& properties = {})
+        : CPipelineEmitter<Out>(properties)
+    {
+    }
+
+protected:
+    // Emit zero or more elements; return false once exhausted.
+    virtual bool Produce() = 0;
+
+    bool HasWork() override { return true; }
+
+    void Tick() override
+    {
+        if (!Produce())
+        {
+            this->Finish();
+        }
+    }
+};
+
+// Inputs and outputs. Process() is called for every element and calls Emit() for its results.
+template<typename In, typename Out>
+class CPipelineStage : public CPipelineEmitter<Out>
+{
+public:
+    using input_type = In;
+
+    explicit CPipelineStage(const ThreadProperties& properties = {})
+        : CPipelineEmitter<Out>(properties)
+    {
+    }
+
+protected:
+    virtual void Process(In& item) = 0;
+
+    bool HasWork() override { return m_inputs.HasItems() || m_inputs.Drained(); }
+
+    void Tick() override
+    {
+        m_inputs.Drain(Constants::pipelineBatch, [this](In& item) {
+            this->RecordItemDwell(item);
+            Process(item);
+        });
+        if (m_inputs.Drained())
+        {
+            this->Finish();
+        }
+    }
+
+private:
+    friend class CPipeline;
+
+    CPipelineInputs<In> m_inputs;
+};
+
+// Inputs only.
+template<typename In>
+class CPipelineSink : public CPipelineStageBase
+{
+public:
+    using input_type = In;
+
+    explicit CPipelineSink(const ThreadProperties& properties = {})
+        : CPipelineStageBase(properties)
+    {
+    }
+
+protected:
+    virtual void Consume(In& item) = 0;
+
+    bool HasWork() override { return m_inputs.HasItems() || m_inputs.Drained(); }
+
+    void Tick() override
+    {
+        m_inputs.Drain(Constants::pipelineBatch, [this](In& item) {
+            RecordItemDwell(item);
+            Consume(item);
+        });
+        if (m_inputs.Drained())
+        {
+            Finish();
+        }
+    }
+
+    void CloseOutputs() override {}
+
+private:
+    friend class CPipeline;
+
+    CPipelineInputs<In> m_inputs;
+};
+
+// Rates cover the interval since the previous CPipeline::Report() (or Start()).
+struct PipelineEdgeReport
+{
+    std::string m_name;
+    std::string m_from;
+    std::string m_to;
+    uint64_t m_pushes{};
+    uint64_t m_pops{};
+    double m_throughput{};     // pops per second
+    size_t m_size{};
+    size_t m_capacity{};
+    double m_fill{};           // size / capacity
+    double m_blockedFraction{}; // share of the interval the producer spent blocked on a full edge
+};
+
+struct PipelineReport
+{
+    double m_intervalSeconds{};
+    std::vector<PipelineEdgeReport> m_edges;
+    // Edge whose consumer limits the graph: the one its producer blocked on longest, or failing
+    // that the fullest edge at or above Constants::pipelineSaturatedFill.
+    std::optional<size_t> m_saturated;
+
+    void Print(std::ostream& out) const;
+};
+
+class CPipeline
+{
+public:
+    CPipeline() = default;
+    ~CPipeline();
+
+    CPipeline(const CPipeline&) = delete;
+    CPipeline& operator=(const CPipeline&) = delete;
+    CPipeline(CPipeline&&) = delete;
+    CPipeline& operator=(CPipeline&&) = delete;
+
+    template<typename Stage, typename... Args>
+    requires std::derived_from<Stage, CPipelineStageBase>
+    Stage& Add(Args&&... args)
+    {
+        auto stage = std::make_unique<Stage>(std::forward<Args>(args)...);
+        Stage& ref = *stage;
+        m_stages.push_back(std::move(stage));
+        return ref;
+    }
+
+    // Adds an edge from -> to. Connect a stage to several consumers for fan-out, several producers to
+    // one stage for fan-in. Call before Start().
+    template<typename From, typename To>
+    requires std::derived_from<From, CPipelineEmitter<typename To::input_type>>
+    void Connect(From& from, To& to, size_t capacity = Constants::pipelineEdgeCapacity, std::string name = {})
+    {
+        using T = typename To::input_type;
+        if (name.empty())
+        {
+            name = from.Name() + "->" + to.Name();
+        }
+        auto edge = std::make_unique<CPipelineEdge<T>>(std::move(name), from, to, capacity);
+        static_cast<CPipelineEmitter<T>&>(from).m_outputs.push_back(edge.get());
+        to.m_inputs.Add(*edge);
+        static_cast<CPipelineStageBase&>(from).m_outputEdges.push_back(edge.get());
+        static_cast<CPipelineStageBase&>(to).m_inputEdges.push_back(edge.get());
+        m_edges.push_back(std::move(edge));
+    }
+
+    // Starts every stage, consumers first. False if the graph has a cycle or was already started.
+    bool Start();
+    // Ordered shutdown: stops the sources, then waits while the close propagates down the graph and
+    // every stage drains its inputs.
+    void Close();
+    // Waits for every stage to finish on its own, in topological order.
+    void Wait();
+    // Abort: closes every edge and stops every stage without draining.
+    void Stop();
+
+    PipelineReport Report();
+
+private:
+    bool SortStages();
+
+    std::vector<std::unique_ptr<CPipelineStageBase>> m_stages;
+    std::vector<std::unique_ptr<CPipelineEdgeBase>> m_edges;
+    std::vector<CPipelineStageBase*> m_order;
+    std::vector<QueueMetricsSnapshot> m_lastSnapshots;
+    uint64_t m_lastReportNs{0};
+    bool m_started{false};
+};
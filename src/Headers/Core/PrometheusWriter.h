@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Core/MessagePool.h"
+#include "Core/ThreadMetrics.h"
+#include "Utils/LatencyHistogram.h"
+#include "Utils/QueueMetrics.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Renders CThreadRegistry and CMetricsRegistry in the Prometheus text exposition format (0.0.4).
+// Every source is read through its snapshot API, so rendering never locks a worker. Row storage and
+// the output string keep their capacity between calls: once the set of threads, queues and histograms
+// is stable, Render() does not allocate. One writer per rendering thread.
+class CPrometheusWriter
+{
+public:
+    void Render(std::string& out);
+
+private:
+    struct Summary
+    {
+        bool m_present{false};
+        uint64_t m_count{};
+        uint64_t m_sum{};
+        uint64_t m_p50{};
+        uint64_t m_p90{};
+        uint64_t m_p99{};
+        uint64_t m_p999{};
+    };
+
+    struct ThreadRow
+    {
+        std::string m_labels;
+        ThreadMetrics m_metrics;
+        Summary m_tick;
+        Summary m_dwell;
+    };
+
+    struct QueueRow
+    {
+        std::string m_labels;
+        QueueMetricsSnapshot m_snapshot;
+        size_t m_size{};
+    };
+
+    struct PoolRow
+    {
+        std::string m_labels;
+        MessagePoolMetrics m_metrics;
+    };
+
+    struct HistogramRow
+    {
+        std::string m_labels;
+        Summary m_summary;
+    };
+
+    void Collect();
+    void WriteThreads(std::string& out) const;
+    void WriteQueues(std::string& out) const;
+    void WritePools(std::string& out) const;
+    void WriteHistograms(std::string& out) const;
+
+    std::vector<ThreadRow> m_threads;
+    std::vector<QueueRow> m_queues;
+    std::vector<PoolRow> m_pools;
+    std::vector<HistogramRow> m_histograms;
+    size_t m_threadCount{0};
+    size_t m_queueCount{0};
+    size_t m_poolCount{0};
+    size_t m_histogramCount{0};
+};
@@ -1,36 +1,43 @@
 #pragma once
 
 #include "Constants.h"
+#include "Core/ThreadMetrics.h"
+#include "Core/ThreadRegistry.h"
+#include "Utils/EventCount.h"
+#include "Utils/Executor.h"
+#include "Utils/LatencyHistogram.h"
+#include "Utils/PerfCounters.h"
 #include "Utils/ThreadConcepts.h"
+#include "Utils/SeqLock.h"
+#include "Utils/ThreadPlacement.h"
+#include "Utils/TimerWheel.h"
+#include "Utils/Trace.h"
 #include "Utils/Utils.h"
+#include "Utils/WaitPolicy.h"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <functional>
+#include <mutex>
 #include <string>
 #include <thread>
-
-struct ThreadMetrics
-{
-    uint64_t m_lastHeartbeatEpochMS;
-    uint64_t m_appLaunchTick;
-    uint64_t m_errorCount{};
-    uint64_t m_tickCount{};
-    double m_messageRate{};
-    uint64_t m_bytesProcessed{0};
-
-    ThreadMetrics()
-    {
-        uint64_t now = Utils::GetTickCountMillis();
-        m_lastHeartbeatEpochMS = now;
-        m_appLaunchTick = now;
-    }
-};
+#include <vector>
 
 struct ThreadProperties
 {
     ThreadMetrics m_metrics{};
     uint16_t m_heartbeatIntervalMS{Constants::heartbeatIntervalMs};
+
+    // Applied by the thread itself before Run(); anything left at its default is not touched.
+    std::string m_name; // truncated to 15 characters
+    std::vector<int> m_cpuAffinity; // empty: any CPU not isolated by another thread
+    bool m_isolateCpus{false}; // keep threads without an explicit affinity off m_cpuAffinity
+    Utils::SchedulingPolicy m_schedPolicy{Utils::SchedulingPolicy::OTHER};
+    int m_schedPriority{0}; // 1-99 for FIFO/RR; anything but 0 with OTHER fails placement
+    bool m_perfCounters{false}; // open a perf_event counter group for the thread
 };
 
 template<typename T, typename U = decltype(T::m_metrics)>
@@ -41,6 +48,9 @@ public:
     explicit CThreadBase(const T& properties)
         : m_properties(properties)
     {
+        m_published.Store(m_properties.m_metrics);
+        CThreadRegistry::Instance().Register(
+            this, m_uuid, m_properties.m_name, [this] { return static_cast<ThreadMetrics>(m_published.Load()); }, &m_tickHistogram, &m_dwellHistogram);
     }
 
     CThreadBase() = delete;
@@ -49,7 +59,11 @@ public:
     CThreadBase& operator=(const CThreadBase&) = delete;
     CThreadBase& operator=(CThreadBase&&) = delete;
 
-    virtual ~CThreadBase() { Stop(); }
+    virtual ~CThreadBase()
+    {
+        Stop();
+        CThreadRegistry::Instance().Unregister(this);
+    }
 
     virtual void Stop()
     {
@@ -57,33 +71,474 @@ public:
         {
             m_isRunning.store(false);
         }
-        if (m_self.joinable())
+        Wake();
+        bool const joined = m_self.joinable();
+        if (joined)
         {
             m_self.join();
         }
+        m_tickJob.WaitDetached();
+        UnbindInputs();
+        ReleasePlacementCpus();
+        if (joined)
+        {
+            SamplePerfCounters();
+            PublishMetrics();
+        }
     }
-    virtual bool Start() = 0;
 
-    [[nodiscard]] virtual const U& GetMetrics() const { return m_properties.m_metrics; }
+    // Runs Run() on a dedicated thread placed according to the properties. Overrides that spawn
+    // their own thread should call ApplyPlacement() from it.
+    virtual bool Start()
+    {
+        if (m_isRunning.exchange(true))
+        {
+            return false;
+        }
+        // Before spawning, so a thread started right after this one already avoids its CPUs.
+        ReservePlacementCpus();
+        m_self = std::thread([this] {
+            ApplyPlacement();
+            TWIZ_TRACE_SCOPE("Run");
+            Run();
+        });
+        return true;
+    }
+
+    // Alternative to Start(): multiplexes Tick() onto a shared executor instead of a dedicated thread.
+    // Stop(), IsRunning() and the metrics behave the same; Run() is not used.
+    bool StartOn(CExecutor& executor)
+    {
+        if (m_isRunning.exchange(true))
+        {
+            return false;
+        }
+        m_tickJob.Attach();
+        executor.Schedule(&m_tickJob);
+        return true;
+    }
+
+    // Explicit wakeup: producers call this after handing the thread input by other means, and
+    // RunScheduled() runs Tick() without waiting for a poll interval. Costs one exchange and one
+    // RMW when the thread is awake.
+    void Wake()
+    {
+        if (!m_wakePending.exchange(true))
+        {
+            m_wakeStampNs.store(Utils::GetTickCountNanos(), std::memory_order_relaxed);
+        }
+        m_events.NotifyOne();
+    }
+
+    // Queue-driven wakeup: every push to queue (and its Close()) wakes a parked RunScheduled(), and
+    // Tick() runs while queue is not empty, with no Wake() call from producers. Call before Start();
+    // Stop() unbinds, so bind again before a restart. A queue signals a single notifier, so a bound
+    // queue cannot also be in a CQueueSelect, and it must outlive the binding.
+    template<typename Queue>
+    void BindInput(Queue& queue)
+    {
+        queue.SetNotifier(&m_events);
+        // Polled on every spin of the idle loop: ApproxSize() keeps that off the default backend's
+        // mutex, which every producer needs.
+        auto ready = [&queue] {
+            if constexpr (requires { queue.ApproxSize(); })
+            {
+                return queue.ApproxSize() != 0;
+            }
+            else
+            {
+                return !queue.Empty();
+            }
+        };
+        m_inputs.push_back({ready, [&queue] { queue.SetNotifier(nullptr); }});
+    }
+
+    // Consistent copy of the metrics as last published by the owning thread. Safe from any thread.
+    [[nodiscard]] U Snapshot() const { return m_published.Load(); }
+    // Tick() duration and message dwell time in ns; Snapshot() them from any thread.
+    [[nodiscard]] const CLatencyHistogram& GetTickHistogram() const { return m_tickHistogram; }
+    [[nodiscard]] const CLatencyHistogram& GetDwellHistogram() const { return m_dwellHistogram; }
     [[nodiscard]] virtual const T& GetProperties() const { return m_properties; }
 
     [[nodiscard]] virtual bool IsRunning() const { return m_isRunning.load(); }
     [[nodiscard]] virtual const std::string& GetUUID() const { return m_uuid; }
 
 protected:
+    // Working copy, updated in place by the owning thread: read it from Tick() and the other hooks.
+    // Other threads use Snapshot().
+    [[nodiscard]] virtual const U& GetMetrics() const { return m_properties.m_metrics; }
+
     virtual void SendHeartbeat()
     {
         uint64_t now = Utils::GetTickCountMillis();
         if (now - m_properties.m_metrics.m_lastHeartbeatEpochMS >= m_properties.m_heartbeatIntervalMS)
         {
-            m_properties.m_metrics.m_lastHeartbeatEpochMS = now;
+            OnHeartbeat();
+            return;
+        }
+        PublishMetrics();
+    }
+
+    virtual void OnHeartbeat()
+    {
+        m_properties.m_metrics.m_lastHeartbeatEpochMS = Utils::GetTickCountMillis();
+        RefreshCpu();
+        SamplePerfCounters();
+        PublishMetrics();
+    }
+
+    // Tick() with its duration recorded. The default Run(), RunScheduled() and the executor path use
+    // it; Run() overrides with their own loop must call it instead of Tick(), or record nothing.
+    void TimedTick()
+    {
+        uint64_t const start = Utils::GetTickCountNanos();
+        Tick();
+        uint64_t const end = Utils::GetTickCountNanos();
+        m_tickHistogram.Record(end - start);
+        if (CTracer::IsEnabled()) [[unlikely]]
+        {
+            CTracer::Complete("Tick", start, end);
+        }
+    }
+
+    // A read() syscall per open counter group, so it runs at the heartbeat interval rather than per tick.
+    void SamplePerfCounters()
+    {
+        PerfCounterValues values;
+        if (m_perf.Read(values))
+        {
+            auto& metrics = m_properties.m_metrics;
+            metrics.m_cycles = values.m_cycles;
+            metrics.m_instructions = values.m_instructions;
+            metrics.m_llcMisses = values.m_llcMisses;
+            metrics.m_branchMisses = values.m_branchMisses;
+            metrics.m_contextSwitches = values.m_contextSwitches;
+        }
+    }
+
+    // Records enqueue-to-dequeue time for anything carrying an m_timestamp set from
+    // Utils::GetTickCountNanos() (Message and its variants). Unstamped messages are skipped.
+    // Pooled handles and other pointers are dereferenced. Opt-in: the base class never sees what
+    // Tick() pops, so dwell is recorded only for messages taken with PopMessage() or passed here.
+    template<typename MessageT>
+    void RecordDwell(const MessageT& message)
+    {
+        if constexpr (requires { message->m_timestamp; })
+        {
+            if (message)
+            {
+                RecordDwell(*message);
+            }
+        }
+        else if (message.m_timestamp != 0)
+        {
+            uint64_t const now = Utils::GetTickCountNanos();
+            m_dwellHistogram.Record(now > message.m_timestamp ? now - message.m_timestamp : 0);
+        }
+    }
+
+    // TryPopValue() that records the popped message's dwell time.
+    template<typename Queue, typename MessageT>
+    bool PopMessage(Queue& queue, MessageT& out)
+    {
+        if (!queue.TryPopValue(out))
+        {
+            return false;
+        }
+        RecordDwell(out);
+        return true;
+    }
+
+    // Owning thread only. SendHeartbeat(), RunScheduled() and the executor path call it at every
+    // tick boundary; loops that do neither should call it after updating the working copy.
+    void PublishMetrics() { m_published.Store(m_properties.m_metrics); }
+
+    // Polled by RunScheduled() alongside Wake() and the bound inputs; override to report input that
+    // arrives without either.
+    virtual bool HasWork() { return false; }
+
+    // Event loop for Run(): Tick() runs as soon as Wake() is called, a BindInput() queue has elements
+    // or HasWork() holds, and timers in
+    // m_timers (the heartbeat among them) fire at their deadlines. When idle the thread spins briefly,
+    // then parks until the next deadline. The spin budget grows while work keeps arriving during it,
+    // and the park timeout doubles up to Constants::schedulerMaxIdleMs while HasWork() stays false.
+    void RunScheduled()
+    {
+        uint64_t const heartbeatNs = static_cast<uint64_t>(m_properties.m_heartbeatIntervalMS) * 1'000'000;
+        CTimerWheel::TimerId const heartbeat = m_timers.ScheduleEvery(Utils::GetTickCountNanos() + heartbeatNs, heartbeatNs, [this] { OnHeartbeat(); });
+        int spin = Constants::waitSpinIterations;
+        uint64_t backoffNs = static_cast<uint64_t>(Constants::tickIntervalMs) * 1'000'000;
+        auto ready = [this] { return IsReady(); };
+
+        while (m_isRunning.load())
+        {
+            RecordTimers(m_timers.Advance(Utils::GetTickCountNanos()));
+            if (TakeWake() || InputPending() || HasWork())
+            {
+                TimedTick();
+                PublishMetrics();
+                backoffNs = static_cast<uint64_t>(Constants::tickIntervalMs) * 1'000'000;
+                continue;
+            }
+            if (Utils::SpinUntil(ready, spin))
+            {
+                spin = std::min(spin * 2, Constants::waitSpinIterations * 8);
+                continue;
+            }
+            spin = std::max(spin / 2, 16);
+
+            PublishMetrics();
+            uint64_t const now = Utils::GetTickCountNanos();
+            uint64_t const deadline = std::min(m_timers.NextDeadline().value_or(UINT64_MAX), now + backoffNs);
+            if (!Park(deadline) && deadline == now + backoffNs)
+            {
+                backoffNs = std::min(backoffNs * 2, static_cast<uint64_t>(Constants::schedulerMaxIdleMs) * 1'000'000);
+            }
+        }
+        m_timers.Cancel(heartbeat);
+    }
+
+    // Call on the thread being placed. Failures (typically EPERM for real-time policies) leave the
+    // thread where the OS put it; m_placementApplied reports whether every request was honoured.
+    void ApplyPlacement()
+    {
+        auto& metrics = m_properties.m_metrics;
+        bool applied = true;
+        if (!m_properties.m_name.empty())
+        {
+            applied &= Utils::SetCurrentThreadName(m_properties.m_name);
+        }
+        if (!m_properties.m_cpuAffinity.empty())
+        {
+            // Already done by Start(); repeated for overrides that spawn their own thread.
+            ReservePlacementCpus();
+            applied &= Utils::SetCurrentThreadAffinity(m_properties.m_cpuAffinity);
+        }
+        else if (std::vector<int> const shared = Utils::GetUnreservedCpus(); !shared.empty())
+        {
+            applied &= Utils::SetCurrentThreadAffinity(shared);
+        }
+        if (m_properties.m_schedPolicy != Utils::SchedulingPolicy::OTHER || m_properties.m_schedPriority != 0)
+        {
+            applied &= Utils::SetCurrentThreadScheduling(m_properties.m_schedPolicy, m_properties.m_schedPriority);
+        }
+
+        Utils::ThreadPlacement const placement = Utils::GetCurrentThreadPlacement();
+        metrics.m_cpu = placement.m_cpu;
+        metrics.m_allowedCpus = placement.m_allowedCpus;
+        metrics.m_schedPolicy = placement.m_policy;
+        metrics.m_schedPriority = placement.m_priority;
+        metrics.m_placementApplied = applied;
+        if (!applied)
+        {
+            ++metrics.m_errorCount;
+        }
+        // Not counted as an error: access is commonly denied and the thread runs fine without it.
+        if (m_properties.m_perfCounters)
+        {
+            metrics.m_perfAvailable = m_perf.Open();
+        }
+        PublishMetrics();
+    }
+
+    // Once per start, however many of Start() and ApplyPlacement() call it; Stop() releases.
+    void ReservePlacementCpus()
+    {
+        if (m_properties.m_isolateCpus && !m_properties.m_cpuAffinity.empty() && !m_cpusReserved.exchange(true))
+        {
+            Utils::ReserveCpus(m_properties.m_cpuAffinity);
+        }
+    }
+
+    void ReleasePlacementCpus()
+    {
+        if (m_cpusReserved.exchange(false))
+        {
+            Utils::ReleaseCpus(m_properties.m_cpuAffinity);
+        }
+    }
+
+    void RefreshCpu()
+    {
+        auto& metrics = m_properties.m_metrics;
+        int const cpu = Utils::GetCurrentCpu();
+        if (metrics.m_cpu >= 0 && cpu != metrics.m_cpu)
+        {
+            ++metrics.m_cpuMigrations;
+        }
+        metrics.m_cpu = cpu;
+    }
+    // Default loop: TimedTick() and the heartbeat once every Constants::tickIntervalMs, so Tick()
+    // durations are recorded without further code. Override for another cadence, or call
+    // RunScheduled() from the override for the event-driven loop.
+    virtual void Run()
+    {
+        auto const interval = std::chrono::milliseconds(Constants::tickIntervalMs);
+        auto next = std::chrono::steady_clock::now();
+        while (m_isRunning.load())
+        {
+            TimedTick();
+            SendHeartbeat();
+            // A Tick() that overran starts the next one at once rather than a burst to catch up.
+            next = std::max(next + interval, std::chrono::steady_clock::now());
+            std::this_thread::sleep_until(next);
         }
     }
-    virtual void Run() = 0;
     virtual void Tick() = 0;
 
     std::thread m_self;
     std::atomic<bool> m_isRunning{false};
     std::string m_uuid{Utils::GenerateUUID()};
     T m_properties{};
+    // Owned by the thread inside RunScheduled(); schedule from Run() or Tick() only.
+    CTimerWheel m_timers{Utils::GetTickCountNanos()};
+
+private:
+    bool TakeWake()
+    {
+        if (!m_wakePending.exchange(false))
+        {
+            return false;
+        }
+        if (uint64_t const stamp = m_wakeStampNs.exchange(0, std::memory_order_relaxed); stamp != 0)
+        {
+            uint64_t const now = Utils::GetTickCountNanos();
+            auto& metrics = m_properties.m_metrics;
+            metrics.m_wakeLatencyMaxNs = std::max(metrics.m_wakeLatencyMaxNs, now > stamp ? now - stamp : 0);
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool InputPending() const
+    {
+        return std::any_of(m_inputs.begin(), m_inputs.end(), [](const BoundInput& input) { return input.m_ready(); });
+    }
+
+    bool IsReady() { return m_wakePending.load(std::memory_order_relaxed) || !m_isRunning.load(std::memory_order_relaxed) || InputPending() || HasWork(); }
+
+    // Returns true when woken by Wake(), Stop() or a bound input, false on timeout. Readiness is
+    // checked after PrepareWait(), so a push or Wake() racing with the park is never lost.
+    bool Park(uint64_t deadlineNs)
+    {
+        ++m_properties.m_metrics.m_idleParks;
+        CEventCount::Key const key = m_events.PrepareWait();
+        if (IsReady())
+        {
+            m_events.CancelWait();
+            return true;
+        }
+        TWIZ_TRACE_SCOPE("Park");
+        // Timer deadlines are GetTickCountNanos() values; only the interval to one is handed to the
+        // wait, so TSC drift from CLOCK_MONOTONIC never accumulates into it.
+        uint64_t const now = Utils::GetTickCountNanos();
+        return m_events.Wait(key, std::chrono::nanoseconds(deadlineNs > now ? deadlineNs - now : 0));
+    }
+
+    void UnbindInputs()
+    {
+        for (const BoundInput& input : m_inputs)
+        {
+            input.m_unbind();
+        }
+        m_inputs.clear();
+    }
+
+    void RecordTimers(const TimerFireStats& stats)
+    {
+        auto& metrics = m_properties.m_metrics;
+        metrics.m_timerFires += stats.m_fired;
+        metrics.m_missedDeadlines += stats.m_missed;
+        metrics.m_timerJitterTotalNs += stats.m_totalLatenessNs;
+        metrics.m_timerJitterMaxNs = std::max(metrics.m_timerJitterMaxNs, stats.m_maxLatenessNs);
+    }
+
+    // One heartbeat + Tick() per executor round while running.
+    class CTickJob : public CExecutorJob
+    {
+    public:
+        explicit CTickJob(CThreadBase& owner)
+            : m_owner(owner)
+        {
+        }
+
+        void Attach()
+        {
+            std::lock_guard<std::mutex> lk(m_detachMutex);
+            m_attached = true;
+        }
+
+        void WaitDetached()
+        {
+            // Stop() from Tick() on the worker running this job: the slice detaches on its way out,
+            // so waiting here would never return.
+            if (m_runner.load() == std::this_thread::get_id())
+            {
+                return;
+            }
+            std::unique_lock<std::mutex> lk(m_detachMutex);
+            m_detachCv.wait(lk, [this] { return !m_attached; });
+        }
+
+        bool RunSlice() override
+        {
+            if (!m_owner.m_isRunning.load())
+            {
+                Detach();
+                return false;
+            }
+            m_runner.store(std::this_thread::get_id());
+            m_owner.SendHeartbeat();
+            m_owner.TimedTick();
+            m_owner.PublishMetrics();
+            m_runner.store(std::thread::id());
+            if (!m_owner.m_isRunning.load())
+            {
+                Detach();
+                return false;
+            }
+            return true;
+        }
+
+        void Cancel() override
+        {
+            m_owner.m_isRunning.store(false);
+            Detach();
+        }
+
+    private:
+        // Last access to the job from the executor. Notifying under the lock keeps WaitDetached(), and
+        // with it the owner's destructor, from returning before the notify is done.
+        void Detach()
+        {
+            std::lock_guard<std::mutex> lk(m_detachMutex);
+            m_attached = false;
+            m_detachCv.notify_all();
+        }
+
+        CThreadBase& m_owner;
+        std::mutex m_detachMutex;
+        std::condition_variable m_detachCv;
+        bool m_attached{false};
+        std::atomic<std::thread::id> m_runner{};
+    };
+
+    CTickJob m_tickJob{*this};
+
+    CSeqLock<U> m_published;
+    CLatencyHistogram m_tickHistogram;
+    CLatencyHistogram m_dwellHistogram;
+    CPerfCounters m_perf;
+
+    std::atomic<bool> m_cpusReserved{false};
+    std::atomic<bool> m_wakePending{false};
+    std::atomic<uint64_t> m_wakeStampNs{0};
+    // Parks RunScheduled(); signalled by Wake() and by every bound input queue.
+    CEventCount m_events;
+
+    struct BoundInput
+    {
+        std::function<bool()> m_ready;
+        std::function<void()> m_unbind;
+    };
+    std::vector<BoundInput> m_inputs;
 };
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Constants.h"
+#include "Utils/ThreadPlacement.h"
+#include "Utils/Utils.h"
+
+#include <cstdint>
+
+// Working copy written only by the owning thread; other threads read the copy CThreadBase publishes
+// through Snapshot(). Aligned so neighbouring threads' metrics never share a cache line.
+struct alignas(Constants::cacheLineSize) ThreadMetrics
+{
+    uint64_t m_lastHeartbeatEpochMS;
+    uint64_t m_appLaunchTick;
+    uint64_t m_errorCount{};
+    uint64_t m_tickCount{};
+    double m_messageRate{};
+    uint64_t m_bytesProcessed{0};
+
+    // Effective placement: captured when the thread starts, CPU refreshed on each heartbeat.
+    int m_cpu{-1};
+    uint64_t m_cpuMigrations{};
+    Utils::CpuMask m_allowedCpus;
+    Utils::SchedulingPolicy m_schedPolicy{Utils::SchedulingPolicy::OTHER};
+    int m_schedPriority{};
+    bool m_placementApplied{false};
+
+    // Scheduler (RunScheduled): timer lateness, deadlines missed by more than Constants::timerSlackUs,
+    // and the delay between Wake() and the Tick() it triggered.
+    uint64_t m_timerFires{};
+    uint64_t m_missedDeadlines{};
+    uint64_t m_timerJitterTotalNs{};
+    uint64_t m_timerJitterMaxNs{};
+    uint64_t m_wakeLatencyMaxNs{};
+    uint64_t m_idleParks{};
+
+    // Hardware counters (ThreadProperties::m_perfCounters), cumulative since the thread started and
+    // refreshed at every heartbeat and on Stop(). All zero while m_perfAvailable is false.
+    bool m_perfAvailable{false};
+    uint64_t m_cycles{};
+    uint64_t m_instructions{};
+    uint64_t m_llcMisses{};
+    uint64_t m_branchMisses{};
+    uint64_t m_contextSwitches{};
+
+    ThreadMetrics()
+    {
+        uint64_t now = Utils::GetTickCountMillis();
+        m_lastHeartbeatEpochMS = now;
+        m_appLaunchTick = now;
+    }
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Core/ThreadMetrics.h"
+#include "Utils/LatencyHistogram.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct ThreadMetricsSummary
+{
+    size_t m_threadCount{};
+    uint64_t m_tickCount{};
+    uint64_t m_errorCount{};
+    uint64_t m_bytesProcessed{};
+    double m_messageRate{};
+    uint64_t m_timerFires{};
+    uint64_t m_missedDeadlines{};
+    uint64_t m_oldestHeartbeatEpochMS{};
+};
+
+// Process-wide list of live CThreadBase instances. Threads join on construction and leave on
+// destruction. Readers only take the snapshots each thread publishes, so enumerating the registry
+// never blocks a worker; the registry lock is shared with registration only.
+class CThreadRegistry
+{
+public:
+    using SnapshotFn = std::function<ThreadMetrics()>;
+
+    static CThreadRegistry& Instance();
+
+    CThreadRegistry(const CThreadRegistry&) = delete;
+    CThreadRegistry& operator=(const CThreadRegistry&) = delete;
+    CThreadRegistry(CThreadRegistry&&) = delete;
+    CThreadRegistry& operator=(CThreadRegistry&&) = delete;
+
+    // The histograms are owned by the thread and must stay valid until Unregister().
+    void Register(const void* owner, std::string uuid, std::string name, SnapshotFn snapshot, const CLatencyHistogram* tickHistogram = nullptr, const CLatencyHistogram* dwellHistogram = nullptr);
+    void Unregister(const void* owner);
+
+    // fn(uuid, name, metrics) for every live thread.
+    template<typename Fn>
+    void ForEach(Fn&& fn) const
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        for (const Entry& entry : m_entries)
+        {
+            fn(entry.m_uuid, entry.m_name, entry.m_snapshot());
+        }
+    }
+
+    // fn(uuid, name, metrics, tickHistogram, dwellHistogram); the histograms may be null.
+    template<typename Fn>
+    void ForEachThread(Fn&& fn) const
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        for (const Entry& entry : m_entries)
+        {
+            fn(entry.m_uuid, entry.m_name, entry.m_snapshot(), entry.m_tickHistogram, entry.m_dwellHistogram);
+        }
+    }
+
+    // fn(uuid, name, tickHistogram, dwellHistogram) for every live thread that registered them.
+    template<typename Fn>
+    void ForEachHistogram(Fn&& fn) const
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        for (const Entry& entry : m_entries)
+        {
+            if (entry.m_tickHistogram && entry.m_dwellHistogram)
+            {
+                fn(entry.m_uuid, entry.m_name, *entry.m_tickHistogram, *entry.m_dwellHistogram);
+            }
+        }
+    }
+
+    [[nodiscard]] ThreadMetricsSummary Aggregate() const;
+    [[nodiscard]] LatencyHistogramSnapshot MergedTickHistogram() const;
+    [[nodiscard]] LatencyHistogramSnapshot MergedDwellHistogram() const;
+    [[nodiscard]] size_t Size() const;
+
+private:
+    CThreadRegistry() = default;
+
+    struct Entry
+    {
+        const void* m_owner;
+        std::string m_uuid;
+        std::string m_name;
+        SnapshotFn m_snapshot;
+        const CLatencyHistogram* m_tickHistogram;
+        const CLatencyHistogram* m_dwellHistogram;
+    };
+
+    mutable std::mutex m_mutex;
+    std::vector<Entry> m_entries;
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Core/MessageCodec.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/bson/bson.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/msgpack/msgpack.hpp>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Message with a fixed-schema payload. T is a plain struct registered with jsoncons' member traits;
+// fields are read as members rather than looked up by key in a DOM.
+//     struct Quote { std::string m_symbol; double m_bid{}; double m_ask{}; };
+//     JSONCONS_ALL_MEMBER_NAME_TRAITS(Quote, (m_symbol, "symbol"), (m_bid, "bid"), (m_ask, "ask"))
+//     TypedMessage<Quote> quote;
+// Schemaless traffic keeps using Message and its jsoncons::json payload.
+template<typename T>
+struct TypedMessage
+{
+    uint64_t m_timestamp{}; // Utils::GetTickCountNanos() when enqueued; 0 if unstamped
+    uint64_t m_id{};
+    T m_payload{};
+    bool m_isProcessed{false};
+};
+
+// CMessageCodec for TypedMessage<T>: same header and payload formats, so a typed producer and a
+// Message consumer (or the reverse) read each other's bytes. Encoding streams the struct's fields
+// straight into the encoder and decoding fills the struct from a cursor; no jsoncons::json DOM is
+// built either way. Decoding fails if the payload does not match T's schema.
+template<typename T>
+class CTypedCodec
+{
+public:
+    explicit CTypedCodec(PayloadFormat format = PayloadFormat::CBOR)
+        : m_format(format)
+    {
+    }
+
+    // Appends one encoded message to out. Returns false, leaving out as it was, if T cannot be
+    // encoded in this format (BSON needs T to map to an object).
+    bool Encode(const TypedMessage<T>& message, std::vector<uint8_t>& out) const
+    {
+        size_t const start = out.size();
+        out.resize(start + CMessageCodec::headerSize);
+        try
+        {
+            EncodePayload(message.m_payload, out);
+        }
+        catch (const std::exception&)
+        {
+            out.resize(start);
+            return false;
+        }
+        size_t const payloadSize = out.size() - start - CMessageCodec::headerSize;
+        if (payloadSize > std::numeric_limits<uint32_t>::max())
+        {
+            out.resize(start);
+            return false;
+        }
+
+        MessageHeader header;
+        header.m_timestamp = message.m_timestamp;
+        header.m_id = message.m_id;
+        header.m_isProcessed = message.m_isProcessed;
+        header.m_format = m_format;
+        header.m_payloadSize = static_cast<uint32_t>(payloadSize);
+        CMessageCodec::WriteHeader(header, out.data() + start);
+        return true;
+    }
+
+    // Decodes one message from the front of bytes. Returns the number of bytes consumed, or 0 if the
+    // input is truncated, malformed or of another schema (out is then unspecified).
+    static size_t Decode(std::span<const uint8_t> bytes, TypedMessage<T>& out)
+    {
+        std::optional<MessageHeader> const header = CMessageCodec::PeekHeader(bytes);
+        if (!header || bytes.size() - CMessageCodec::headerSize < header->m_payloadSize)
+        {
+            return 0;
+        }
+        try
+        {
+            out.m_payload = DecodePayload(bytes.subspan(CMessageCodec::headerSize, header->m_payloadSize), header->m_format);
+        }
+        catch (const std::exception&)
+        {
+            return 0;
+        }
+        out.m_timestamp = header->m_timestamp;
+        out.m_id = header->m_id;
+        out.m_isProcessed = header->m_isProcessed;
+        return CMessageCodec::headerSize + header->m_payloadSize;
+    }
+
+    [[nodiscard]] PayloadFormat Format() const noexcept { return m_format; }
+
+private:
+    void EncodePayload(const T& payload, std::vector<uint8_t>& out) const
+    {
+        switch (m_format)
+        {
+        case PayloadFormat::JSON:
+        {
+            // Per thread, so text encoding does not allocate per call.
+            thread_local std::string text;
+            text.clear();
+            jsoncons::encode_json(payload, text);
+            out.insert(out.end(), text.begin(), text.end());
+            break;
+        }
+        case PayloadFormat::CBOR:
+            jsoncons::cbor::encode_cbor(payload, out);
+            break;
+        case PayloadFormat::MSGPACK:
+            jsoncons::msgpack::encode_msgpack(payload, out);
+            break;
+        case PayloadFormat::BSON:
+            jsoncons::bson::encode_bson(payload, out);
+            break;
+        }
+    }
+
+    static T DecodePayload(std::span<const uint8_t> bytes, PayloadFormat format)
+    {
+        switch (format)
+        {
+        case PayloadFormat::JSON:
+            return jsoncons::decode_json<T>(std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size()));
+        case PayloadFormat::CBOR:
+            return jsoncons::cbor::decode_cbor<T>(bytes.begin(), bytes.end());
+        case PayloadFormat::MSGPACK:
+            return jsoncons::msgpack::decode_msgpack<T>(bytes.begin(), bytes.end());
+        case PayloadFormat::BSON:
+            return jsoncons::bson::decode_bson<T>(bytes.begin(), bytes.end());
+        }
+        return T{};
+    }
+
+    PayloadFormat m_format;
+};
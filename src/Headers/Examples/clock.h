@@ -0,0 +1,6 @@
+#pragma once
+
+namespace Twiz
+{
+    void ClockBenchmark();
+} // namespace Twiz
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace Twiz
+{
+    void CodecBenchmark();
+} // namespace Twiz
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace Twiz
+{
+    void CoroutineExample();
+} // namespace Twiz
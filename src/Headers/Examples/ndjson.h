@@ -0,0 +1,6 @@
+#pragma once
+
+namespace Twiz
+{
+    void NdjsonIngestBenchmark();
+} // namespace Twiz
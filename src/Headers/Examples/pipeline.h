@@ -0,0 +1,6 @@
+#pragma once
+
+namespace Twiz
+{
+    void PipelineExample();
+} // namespace Twiz
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace Twiz
+{
+    void QueueBenchmark();
+} // namespace Twiz
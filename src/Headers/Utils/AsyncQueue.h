@@ -0,0 +1,303 @@
+#pragma once
+
+#include "Constants.h"
+#include "Utils/Coroutine.h"
+#include "Utils/MpmcQueue.h"
+#include "Utils/Queue.h"
+#include "Utils/QueueMetrics.h"
+#include "Utils/WaitPolicy.h"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+// Awaitable front end for a CQueue: co_await queue.Pop() / co_await queue.Push(x) suspend the calling
+// coroutine instead of blocking its thread. Elements flow through the wrapped CQueue (MpmcRing by
+// default), so the fast path is the backend's TryPush/TryPopValue plus one check for waiters; only a
+// coroutine that finds the queue empty (or full) takes the waiter lock. The waiter node lives in the
+// awaiting frame, so suspending never allocates. Code outside coroutines uses TryPush/TryPop.
+//     CAsyncQueue<Message> inbox(256);
+//     while (std::optional<Message> message = co_await inbox.Pop()) { ... }
+// T must be default constructible.
+template<typename T, typename Container = MpmcRing, typename Metrics = NoQueueMetrics>
+class CAsyncQueue
+{
+    struct Waiter
+    {
+        Waiter* m_next{nullptr};
+        CCoroResumer m_resumer;
+    };
+
+    // FIFO of suspended awaiters; m_count is read without the lock to skip it when nobody waits.
+    struct WaiterList
+    {
+        Waiter* m_head{nullptr};
+        Waiter* m_tail{nullptr};
+        std::atomic<size_t> m_count{0};
+
+        void Append(Waiter& waiter)
+        {
+            waiter.m_next = nullptr;
+            (m_tail ? m_tail->m_next : m_head) = &waiter;
+            m_tail = &waiter;
+        }
+
+        Waiter* TakeFront()
+        {
+            Waiter* const waiter = m_head;
+            m_head = waiter->m_next;
+            if (!m_head)
+            {
+                m_tail = nullptr;
+            }
+            m_count.fetch_sub(1, std::memory_order_relaxed);
+            return waiter;
+        }
+
+        Waiter* TakeAll()
+        {
+            m_tail = nullptr;
+            m_count.store(0, std::memory_order_relaxed);
+            return std::exchange(m_head, nullptr);
+        }
+
+        // RMW for the same store-load ordering as CEventCount::HasWaiters.
+        [[nodiscard]] bool HasWaiters() noexcept { return m_count.fetch_add(0, std::memory_order_seq_cst) != 0; }
+    };
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+
+    class PopAwaiter : Waiter
+    {
+    public:
+        explicit PopAwaiter(CAsyncQueue& queue)
+            : m_queue(queue)
+        {
+        }
+
+        bool await_ready() { return m_queue.TryPop(m_value); }
+
+        template<typename Promise>
+        bool await_suspend(std::coroutine_handle<Promise> handle)
+        {
+            this->m_resumer = CCoroResumer::For(handle);
+            return m_queue.SuspendPop(*this);
+        }
+
+        // nullopt once the queue is closed and drained.
+        std::optional<T> await_resume() { return std::move(m_value); }
+
+    private:
+        friend class CAsyncQueue;
+
+        CAsyncQueue& m_queue;
+        std::optional<T> m_value;
+    };
+
+    class PushAwaiter : Waiter
+    {
+    public:
+        PushAwaiter(CAsyncQueue& queue, T value)
+            : m_queue(queue)
+            , m_value(std::move(value))
+        {
+        }
+
+        bool await_ready() { return m_queue.TryPush(std::move(m_value)); }
+
+        template<typename Promise>
+        bool await_suspend(std::coroutine_handle<Promise> handle)
+        {
+            this->m_resumer = CCoroResumer::For(handle);
+            return m_queue.SuspendPush(*this);
+        }
+
+        // false if the queue was closed before the element went in.
+        bool await_resume() const noexcept { return m_pushed; }
+
+    private:
+        friend class CAsyncQueue;
+
+        CAsyncQueue& m_queue;
+        T m_value;
+        bool m_pushed{true};
+    };
+
+    CAsyncQueue()
+        : CAsyncQueue(Constants::maxQueueSize)
+    {
+    }
+    explicit CAsyncQueue(size_t capacity)
+        : m_queue(capacity)
+    {
+    }
+
+    CAsyncQueue(const CAsyncQueue&) = delete;
+    CAsyncQueue& operator=(const CAsyncQueue&) = delete;
+    CAsyncQueue(CAsyncQueue&&) = delete;
+    CAsyncQueue& operator=(CAsyncQueue&&) = delete;
+
+    // co_await: the next element, or nullopt once closed and drained.
+    [[nodiscard]] PopAwaiter Pop() { return PopAwaiter(*this); }
+    // co_await: true once the element is queued, false if the queue is closed.
+    [[nodiscard]] PushAwaiter Push(T value) { return PushAwaiter(*this, std::move(value)); }
+
+    // Never suspends; safe from any thread. value is left untouched on failure.
+    template<typename U>
+    bool TryPush(U&& value)
+    {
+        if (!m_queue.TryPush(std::forward<U>(value)))
+        {
+            return false;
+        }
+        Dispatch();
+        return true;
+    }
+
+    bool TryPop(std::optional<T>& out)
+    {
+        T value{};
+        if (!m_queue.TryPopValue(value))
+        {
+            return false;
+        }
+        out.emplace(std::move(value));
+        Dispatch();
+        return true;
+    }
+
+    // Suspended pushes resume with false; suspended pops take what is left, then see nullopt.
+    void Close()
+    {
+        Waiter* pushers = nullptr;
+        Waiter* poppers = nullptr;
+        {
+            std::lock_guard<std::mutex> lk(m_waitMutex);
+            m_closed = true;
+            m_queue.Close();
+            pushers = m_pushers.TakeAll();
+            poppers = m_poppers.TakeAll();
+            for (Waiter* waiter = pushers; waiter; waiter = waiter->m_next)
+            {
+                static_cast<PushAwaiter*>(waiter)->m_pushed = false;
+            }
+            for (Waiter* waiter = poppers; waiter; waiter = waiter->m_next)
+            {
+                T value{};
+                if (m_queue.TryPopValue(value))
+                {
+                    static_cast<PopAwaiter*>(waiter)->m_value.emplace(std::move(value));
+                }
+            }
+        }
+        ResumeAll(pushers);
+        ResumeAll(poppers);
+    }
+
+    [[nodiscard]] bool Empty() const noexcept { return m_queue.Empty(); }
+    [[nodiscard]] size_type Size() const noexcept { return m_queue.Size(); }
+    [[nodiscard]] const Metrics& GetMetrics() const noexcept { return m_queue.GetMetrics(); }
+
+private:
+    // Returns false (do not suspend) if an element arrived or the queue closed meanwhile.
+    bool SuspendPop(PopAwaiter& awaiter)
+    {
+        {
+            std::lock_guard<std::mutex> lk(m_waitMutex);
+            m_poppers.m_count.fetch_add(1, std::memory_order_seq_cst);
+            T value{};
+            if (m_queue.TryPopValue(value))
+            {
+                awaiter.m_value.emplace(std::move(value));
+            }
+            else if (!m_closed)
+            {
+                m_poppers.Append(awaiter);
+                return true;
+            }
+            m_poppers.m_count.fetch_sub(1, std::memory_order_relaxed);
+        }
+        Dispatch();
+        return false;
+    }
+
+    bool SuspendPush(PushAwaiter& awaiter)
+    {
+        {
+            std::lock_guard<std::mutex> lk(m_waitMutex);
+            if (m_closed)
+            {
+                awaiter.m_pushed = false;
+                return false;
+            }
+            m_pushers.m_count.fetch_add(1, std::memory_order_seq_cst);
+            if (!m_queue.TryPush(std::move(awaiter.m_value)))
+            {
+                m_pushers.Append(awaiter);
+                return true;
+            }
+            m_pushers.m_count.fetch_sub(1, std::memory_order_relaxed);
+        }
+        Dispatch();
+        return false;
+    }
+
+    // After any push or pop: moves suspended pushers' elements in while there is room and hands
+    // elements to suspended poppers while there are any, then resumes them outside the lock.
+    void Dispatch()
+    {
+        if (!m_poppers.HasWaiters() && !m_pushers.HasWaiters())
+        {
+            return;
+        }
+        WaiterList ready;
+        {
+            std::lock_guard<std::mutex> lk(m_waitMutex);
+            bool progress = true;
+            while (progress)
+            {
+                progress = false;
+                while (m_pushers.m_head && m_queue.TryPush(std::move(static_cast<PushAwaiter*>(m_pushers.m_head)->m_value)))
+                {
+                    ready.Append(*m_pushers.TakeFront());
+                    progress = true;
+                }
+                while (m_poppers.m_head)
+                {
+                    T value{};
+                    if (!m_queue.TryPopValue(value))
+                    {
+                        break;
+                    }
+                    Waiter* const waiter = m_poppers.TakeFront();
+                    static_cast<PopAwaiter*>(waiter)->m_value.emplace(std::move(value));
+                    ready.Append(*waiter);
+                    progress = true;
+                }
+            }
+        }
+        ResumeAll(ready.m_head);
+    }
+
+    // A resumed awaiter's frame may be gone before Resume() returns, so read m_next first.
+    static void ResumeAll(Waiter* waiter)
+    {
+        while (waiter)
+        {
+            Waiter* const next = waiter->m_next;
+            waiter->m_resumer.Resume();
+            waiter = next;
+        }
+    }
+
+    CQueue<T, Container, ParkWait, Metrics> m_queue;
+    std::mutex m_waitMutex;
+    WaiterList m_poppers;
+    WaiterList m_pushers;
+    bool m_closed{false};
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SIZEOF_INT128__)
+#define TWIZ_TSC_CLOCK 1
+#include <x86intrin.h>
+#endif
+
+namespace Utils
+{
+
+    // -- Monotonic Nanosecond Clock --
+    // Reads the invariant TSC and scales it with a calibration taken against CLOCK_MONOTONIC once, on
+    // first use (Constants::clockCalibrationMs of busy waiting on the calling thread). Latency-sensitive
+    // programs call CalibrateClock() at startup, so no worker pays for it. Values start on steady_clock's
+    // epoch, but the scale is only as exact as that window, so they drift from it by a few ppm: use them
+    // for timestamps and intervals, and wait on relative timeouts or steady_clock deadlines rather than
+    // converting a value into a steady_clock time_point. Without an invariant TSC it falls back to
+    // clock_gettime, served by the vDSO.
+
+    struct ClockCalibration
+    {
+        uint64_t m_tscBase{};
+        uint64_t m_nanosBase{};
+        uint64_t m_multiplier{}; // ns per TSC tick as a 32.32 fixed-point value
+        int64_t m_wallOffsetNs{}; // CLOCK_REALTIME - CLOCK_MONOTONIC at calibration
+        bool m_useTsc{false};
+    };
+
+    ClockCalibration MeasureClockCalibration();
+    uint64_t ReadMonotonicNanos() noexcept;
+
+    // Calibrates on the first call from any thread; later calls return the same values.
+    inline const ClockCalibration& GetClockCalibration()
+    {
+        static const ClockCalibration calibration = MeasureClockCalibration();
+        return calibration;
+    }
+
+    // Takes the calibration now, on the calling thread, if it has not been taken yet.
+    inline void CalibrateClock() { (void)GetClockCalibration(); }
+
+    inline uint64_t GetTickCountNanos() noexcept
+    {
+#ifdef TWIZ_TSC_CLOCK
+        const ClockCalibration& calibration = GetClockCalibration();
+        if (calibration.m_useTsc)
+        {
+            uint64_t const tsc = __rdtsc();
+            // Another core's TSC may trail the calibrating one by a few cycles.
+            uint64_t const elapsed = tsc > calibration.m_tscBase ? tsc - calibration.m_tscBase : 0;
+            return calibration.m_nanosBase + static_cast<uint64_t>((static_cast<unsigned __int128>(elapsed) * calibration.m_multiplier) >> 32);
+        }
+#endif
+        return ReadMonotonicNanos();
+    }
+
+    // Wall time for a GetTickCountNanos() value, using the offset captured at calibration.
+    inline uint64_t TickNanosToEpochNanos(uint64_t tickNanos) noexcept { return static_cast<uint64_t>(static_cast<int64_t>(tickNanos) + GetClockCalibration().m_wallOffsetNs); }
+    // The inverse, for a wall time recorded earlier; times before this boot map to 0.
+    inline uint64_t EpochNanosToTickNanos(uint64_t epochNanos) noexcept
+    {
+        int64_t const tickNanos = static_cast<int64_t>(epochNanos) - GetClockCalibration().m_wallOffsetNs;
+        return tickNanos > 0 ? static_cast<uint64_t>(tickNanos) : 0;
+    }
+    inline uint64_t GetEpochNanos() noexcept { return TickNanosToEpochNanos(GetTickCountNanos()); }
+    inline bool IsTscClock() noexcept { return GetClockCalibration().m_useTsc; }
+
+} // namespace Utils
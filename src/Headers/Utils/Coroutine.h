@@ -0,0 +1,299 @@
+#pragma once
+
+#include "Utils/Executor.h"
+#include "Utils/LatencyHistogram.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Coroutine actors multiplexed onto a small CExecutor. A suspended actor costs its frame only: no
+// stack, no thread. Awaitables (CAsyncQueue::Pop/Push, CCoroScheduler::Yield) hand the actor back to
+// its scheduler when they resume it; coroutines without a scheduler are resumed inline.
+//     CCoroScheduler scheduler(2);
+//     scheduler.Spawn(Consume(inbox));   // CActorTask Consume(CAsyncQueue<Message>& inbox)
+//     ...
+//     scheduler.WaitIdle();
+
+class CCoroScheduler;
+
+// Join point for one actor: Wait() returns once its frame is gone. Signalled under the lock, so the
+// waiter may destroy it as soon as Wait() returns. A running flag passed to Reset() is cleared on
+// the same path.
+class CCoroCompletion
+{
+public:
+    void Reset(std::atomic<bool>* running = nullptr)
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_done = false;
+        m_running = running;
+    }
+
+    void Signal()
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        if (m_running)
+        {
+            m_running->store(false);
+        }
+        m_done = true;
+        m_cv.notify_all();
+    }
+
+    void Wait()
+    {
+        std::unique_lock<std::mutex> lk(m_mutex);
+        m_cv.wait(lk, [this] { return m_done; });
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_done{true};
+    std::atomic<bool>* m_running{nullptr};
+};
+
+// Resumes this coroutine as a one-shot executor job. Lives in the promise, so scheduling a resume
+// never allocates.
+class CCoroResumeJob : public CExecutorJob
+{
+public:
+    explicit CCoroResumeJob(std::coroutine_handle<> handle)
+        : m_handle(handle)
+    {
+    }
+
+    bool RunSlice() override
+    {
+        m_handle.resume();
+        return false;
+    }
+
+    // The executor stopped before the resume ran: the frame is destroyed without finishing.
+    void Cancel() override { m_handle.destroy(); }
+
+private:
+    std::coroutine_handle<> m_handle;
+};
+
+// Fire-and-forget actor coroutine. Starts suspended; CCoroScheduler::Spawn() takes ownership and
+// schedules it. An exception escaping the actor terminates the process, as it would on a std::thread.
+class CActorTask
+{
+public:
+    struct promise_type
+    {
+        promise_type()
+            : m_resumeJob(std::coroutine_handle<promise_type>::from_promise(*this))
+        {
+        }
+
+        ~promise_type();
+
+        promise_type(const promise_type&) = delete;
+        promise_type& operator=(const promise_type&) = delete;
+        promise_type(promise_type&&) = delete;
+        promise_type& operator=(promise_type&&) = delete;
+
+        CActorTask get_return_object() noexcept { return CActorTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        // The frame frees itself when the actor returns.
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+
+        CCoroScheduler* m_scheduler{nullptr};
+        CCoroResumeJob m_resumeJob;
+        CCoroCompletion* m_completion{nullptr};
+    };
+
+    CActorTask(CActorTask&& other) noexcept
+        : m_handle(std::exchange(other.m_handle, {}))
+    {
+    }
+    CActorTask& operator=(CActorTask&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Reset();
+            m_handle = std::exchange(other.m_handle, {});
+        }
+        return *this;
+    }
+    CActorTask(const CActorTask&) = delete;
+    CActorTask& operator=(const CActorTask&) = delete;
+
+    // A task that was never spawned is destroyed with it.
+    ~CActorTask() { Reset(); }
+
+    // Signals completion once the frame is gone (finished or cancelled), clearing running if given.
+    CActorTask& NotifyOnCompletion(CCoroCompletion& completion, std::atomic<bool>* running = nullptr)
+    {
+        completion.Reset(running);
+        m_handle.promise().m_completion = &completion;
+        return *this;
+    }
+
+private:
+    friend class CCoroScheduler;
+
+    explicit CActorTask(std::coroutine_handle<promise_type> handle)
+        : m_handle(handle)
+    {
+    }
+
+    void Reset()
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+            m_handle = {};
+        }
+    }
+
+    std::coroutine_handle<promise_type> Release() { return std::exchange(m_handle, {}); }
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+// Captured by an awaitable when it suspends; Resume() continues the coroutine on its scheduler.
+class CCoroResumer
+{
+public:
+    CCoroResumer() = default;
+
+    template<typename Promise>
+    static CCoroResumer For(std::coroutine_handle<Promise> handle)
+    {
+        CCoroResumer resumer;
+        resumer.m_handle = handle;
+        if constexpr (std::is_same_v<Promise, CActorTask::promise_type>)
+        {
+            resumer.m_scheduler = handle.promise().m_scheduler;
+            resumer.m_job = &handle.promise().m_resumeJob;
+        }
+        return resumer;
+    }
+
+    void Resume() const;
+
+private:
+    std::coroutine_handle<> m_handle;
+    CCoroScheduler* m_scheduler{nullptr};
+    CExecutorJob* m_job{nullptr};
+};
+
+// Runs actors on a fixed set of executor workers. Per-worker tick and dwell histograms (fed by
+// CCoroThreadBase) are registered with CMetricsRegistry as "<name>.w<i>.tick" / ".dwell": one
+// histogram per actor would cost more than the actor itself.
+class CCoroScheduler
+{
+public:
+    explicit CCoroScheduler(size_t workerCount = std::thread::hardware_concurrency(), std::string name = "coro");
+    ~CCoroScheduler();
+
+    CCoroScheduler(const CCoroScheduler&) = delete;
+    CCoroScheduler& operator=(const CCoroScheduler&) = delete;
+    CCoroScheduler(CCoroScheduler&&) = delete;
+    CCoroScheduler& operator=(CCoroScheduler&&) = delete;
+
+    void Spawn(CActorTask task);
+    // Blocks until every spawned actor has finished.
+    void WaitIdle();
+    // Stops the workers. Actors waiting to run are destroyed; close the queues actors wait on first.
+    void Stop();
+
+    class YieldAwaiter
+    {
+    public:
+        explicit YieldAwaiter(CCoroScheduler& scheduler)
+            : m_scheduler(scheduler)
+        {
+        }
+
+        bool await_ready() const noexcept { return false; }
+
+        template<typename Promise>
+        void await_suspend(std::coroutine_handle<Promise> handle)
+        {
+            if constexpr (std::is_same_v<Promise, CActorTask::promise_type>)
+            {
+                m_scheduler.m_executor.Defer(&handle.promise().m_resumeJob);
+            }
+            else
+            {
+                handle.resume();
+            }
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        CCoroScheduler& m_scheduler;
+    };
+
+    // co_await scheduler.Yield(): lets the actors queued on this worker run first.
+    [[nodiscard]] YieldAwaiter Yield() { return YieldAwaiter(*this); }
+
+    [[nodiscard]] size_t LiveActors() const noexcept { return m_live.load(std::memory_order_acquire); }
+    [[nodiscard]] size_t WorkerCount() const noexcept { return m_executor.WorkerCount(); }
+
+    // Recorded into the calling worker's histogram; ignored off the scheduler's threads.
+    void RecordTick(uint64_t durationNs);
+    void RecordDwell(uint64_t dwellNs);
+    [[nodiscard]] LatencyHistogramSnapshot TickHistogram() const;
+    [[nodiscard]] LatencyHistogramSnapshot DwellHistogram() const;
+
+private:
+    friend class CCoroResumer;
+    friend struct CActorTask::promise_type;
+
+    struct WorkerHistograms
+    {
+        CLatencyHistogram m_tick;
+        CLatencyHistogram m_dwell;
+    };
+
+    void Schedule(CExecutorJob* job) { m_executor.Schedule(job); }
+    void OnActorDone();
+
+    std::string m_name;
+    std::vector<std::unique_ptr<WorkerHistograms>> m_histograms;
+    std::atomic<size_t> m_live{0};
+    CExecutor m_executor;
+};
+
+inline CActorTask::promise_type::~promise_type()
+{
+    if (m_scheduler)
+    {
+        m_scheduler->OnActorDone();
+    }
+    if (m_completion)
+    {
+        m_completion->Signal();
+    }
+}
+
+inline void CCoroResumer::Resume() const
+{
+    if (m_scheduler)
+    {
+        m_scheduler->Schedule(m_job);
+    }
+    else
+    {
+        m_handle.resume();
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+struct MemoryStats
+{
+    uint64_t m_allocations{};
+    uint64_t m_deallocations{};
+    uint64_t m_bytesAllocated{}; // cumulative
+    uint64_t m_bytesInUse{};
+    uint64_t m_peakBytes{};
+};
+
+// Pass-through memory resource that counts what reaches its upstream: calls, bytes and the peak in
+// use. Put it under a pmr arena to see what the arena costs the system allocator, or directly under a
+// pmr container to measure the plain heap. Not thread-safe, like the arenas it sits under.
+class CCountingResource : public std::pmr::memory_resource
+{
+public:
+    explicit CCountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept
+        : m_upstream(upstream)
+    {
+    }
+
+    [[nodiscard]] const MemoryStats& Stats() const noexcept { return m_stats; }
+
+    // Starts a new measurement window; bytes still in use carry over.
+    void ResetStats() noexcept
+    {
+        uint64_t const inUse = m_stats.m_bytesInUse;
+        m_stats = MemoryStats{};
+        m_stats.m_bytesInUse = inUse;
+        m_stats.m_peakBytes = inUse;
+    }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        void* const p = m_upstream->allocate(bytes, alignment);
+        ++m_stats.m_allocations;
+        m_stats.m_bytesAllocated += bytes;
+        m_stats.m_bytesInUse += bytes;
+        m_stats.m_peakBytes = std::max(m_stats.m_peakBytes, m_stats.m_bytesInUse);
+        return p;
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    {
+        m_upstream->deallocate(p, bytes, alignment);
+        ++m_stats.m_deallocations;
+        m_stats.m_bytesInUse -= bytes;
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    std::pmr::memory_resource* m_upstream;
+    MemoryStats m_stats;
+};
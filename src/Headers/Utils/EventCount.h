@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Futex-backed event count: lets a thread park on "some condition became true" without a mutex.
+// Waiter protocol:   key = PrepareWait(); if (condition) CancelWait(); else Wait(key);
+// Notifier protocol: publish state change; NotifyOne() / NotifyAll().
+// Notify is a single load when nobody is waiting, so signalling on every push/pop is cheap.
+// On Linux waiters block on a futex directly, which is what lets Wait() take a timeout; elsewhere
+// the timed wait polls.
+class CEventCount
+{
+public:
+    using Key = uint32_t;
+
+    CEventCount() = default;
+    CEventCount(const CEventCount&) = delete;
+    CEventCount& operator=(const CEventCount&) = delete;
+    CEventCount(CEventCount&&) = delete;
+    CEventCount& operator=(CEventCount&&) = delete;
+
+    [[nodiscard]] Key PrepareWait() noexcept
+    {
+        m_waiters.fetch_add(1, std::memory_order_seq_cst);
+        return m_epoch.load(std::memory_order_acquire);
+    }
+
+    void CancelWait() noexcept { m_waiters.fetch_sub(1, std::memory_order_relaxed); }
+
+    void Wait(Key key) noexcept
+    {
+        while (m_epoch.load(std::memory_order_acquire) == key)
+        {
+            Block(key, -1);
+        }
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Wait() for at most timeout, measured on CLOCK_MONOTONIC. False if it ran out before a notify.
+    bool Wait(Key key, std::chrono::nanoseconds timeout) noexcept;
+
+    // Parks until ready() holds, re-checking it after every wakeup.
+    template<typename Ready>
+    void WaitUntil(Ready&& ready)
+    {
+        while (!ready())
+        {
+            Key const key = PrepareWait();
+            if (ready())
+            {
+                CancelWait();
+                return;
+            }
+            Wait(key);
+        }
+    }
+
+    void NotifyOne() noexcept
+    {
+        if (HasWaiters())
+        {
+            m_epoch.fetch_add(1, std::memory_order_release);
+            Wake(false);
+        }
+    }
+
+    void NotifyAll() noexcept
+    {
+        if (HasWaiters())
+        {
+            m_epoch.fetch_add(1, std::memory_order_release);
+            Wake(true);
+        }
+    }
+
+private:
+    // RMW rather than a plain load: orders the caller's preceding publish against the waiter count
+    // (store-load), pairing with the fetch_add in PrepareWait.
+    [[nodiscard]] bool HasWaiters() noexcept { return m_waiters.fetch_add(0, std::memory_order_seq_cst) != 0; }
+
+    // Sleeps while m_epoch holds key, for at most timeoutNs (negative: no limit). May return early.
+    void Block(Key key, int64_t timeoutNs) noexcept;
+    void Wake(bool all) noexcept;
+
+    std::atomic<uint32_t> m_epoch{0};
+    std::atomic<uint32_t> m_waiters{0};
+};
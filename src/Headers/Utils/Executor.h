@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Utils/Queue.h"
+#include "Utils/WorkStealingDeque.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// A unit of work multiplexed onto CExecutor.
+class CExecutorJob
+{
+public:
+    CExecutorJob() = default;
+    CExecutorJob(const CExecutorJob&) = delete;
+    CExecutorJob& operator=(const CExecutorJob&) = delete;
+    CExecutorJob(CExecutorJob&&) = delete;
+    CExecutorJob& operator=(CExecutorJob&&) = delete;
+    virtual ~CExecutorJob() = default;
+
+    // Runs one slice. Return true to run again in the next round, false to leave the executor.
+    virtual bool RunSlice() = 0;
+    // Called instead of RunSlice for jobs still queued when the executor stops.
+    virtual void Cancel() {}
+};
+
+// Work-stealing executor: one worker thread per core, each with its own Chase-Lev deque. Workers pop
+// their own deque LIFO, then take from the shared injection queue, then steal FIFO from the others.
+// Rescheduled jobs run once per round. A worker whose round finishes early waits out the rest of
+// Constants::tickIntervalMs, the cadence of a dedicated CThreadBase loop, unless there is work to steal.
+class CExecutor
+{
+public:
+    explicit CExecutor(size_t workerCount = std::thread::hardware_concurrency());
+    ~CExecutor();
+
+    CExecutor(const CExecutor&) = delete;
+    CExecutor& operator=(const CExecutor&) = delete;
+    CExecutor(CExecutor&&) = delete;
+    CExecutor& operator=(CExecutor&&) = delete;
+
+    // The job is not owned and must stay alive until it leaves the executor or is cancelled. Once
+    // Stop() has begun, it is cancelled instead of queued.
+    void Schedule(CExecutorJob* job);
+    // Schedule() through the shared injection queue, behind everything already queued there. Lets a
+    // job yield to the ones waiting on its own worker.
+    void Defer(CExecutorJob* job);
+    // One-shot task; the executor owns it.
+    void Submit(std::function<void()> task);
+    // Stops admission and waits out Schedule()/Defer() calls already past it, then joins the workers
+    // and cancels every job that was still queued. Idempotent.
+    void Stop();
+
+    [[nodiscard]] size_t WorkerCount() const noexcept { return m_workers.size(); }
+    // Index of the calling worker thread, or nullopt when called from outside this executor.
+    [[nodiscard]] std::optional<size_t> CurrentWorker() const noexcept;
+    [[nodiscard]] bool IsRunning() const noexcept { return m_running.load(std::memory_order_acquire); }
+
+private:
+    struct Worker
+    {
+        CWorkStealingDeque<CExecutorJob*> m_deque;
+        std::vector<CExecutorJob*> m_nextRound;
+        std::thread m_thread;
+    };
+
+    // Enter before queueing a job, Leave after; Enter fails once Stop() has begun.
+    bool EnterAdmission() noexcept;
+    void LeaveAdmission() noexcept { m_admitting.fetch_sub(1, std::memory_order_release); }
+    void WorkerLoop(size_t index);
+    CExecutorJob* FindJob(size_t index);
+    void StartNextRound(Worker& worker);
+    void Idle(std::chrono::steady_clock::time_point deadline);
+    [[nodiscard]] bool HasQueuedWork() const;
+    void WakeIdle();
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    CQueue<CExecutorJob*> m_injection;
+    std::atomic<bool> m_running{true};
+    std::atomic<size_t> m_admitting{0}; // Schedule()/Defer() calls between the m_running check and the push
+
+    std::mutex m_idleMutex;
+    std::condition_variable m_idleCv;
+    std::atomic<size_t> m_sleepers{0};
+};
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "Constants.h"
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <utility>
+
+// Drain policies for CLaneQueue: Next(sizes) returns the lane to pop from; at least one lane is non-empty.
+
+// Always drains the lowest-numbered non-empty lane. Lane 0 is the highest priority.
+struct StrictPriorityDrain
+{
+    template<size_t Lanes>
+    size_t Next(const std::array<size_t, Lanes>& sizes)
+    {
+        for (size_t lane = 0; lane < Lanes; ++lane)
+        {
+            if (sizes[lane] > 0)
+            {
+                return lane;
+            }
+        }
+        return 0;
+    }
+};
+
+// Weighted round robin: each lane may pop up to its weight in a row before the next non-empty lane gets
+// a turn, so no lane starves and a lane waits at most sum(weights) pops.
+template<size_t Lanes>
+class CWeightedDrain
+{
+public:
+    CWeightedDrain() { m_weights.fill(1); }
+    explicit CWeightedDrain(const std::array<uint32_t, Lanes>& weights)
+        : m_weights(weights)
+    {
+    }
+
+    size_t Next(const std::array<size_t, Lanes>& sizes)
+    {
+        for (size_t step = 0; step <= Lanes; ++step)
+        {
+            if (sizes[m_current] > 0 && m_credit < m_weights[m_current])
+            {
+                ++m_credit;
+                return m_current;
+            }
+            m_current = (m_current + 1) % Lanes;
+            m_credit = 0;
+        }
+        // Only zero-weight lanes hold elements; drain them in order rather than stall.
+        return StrictPriorityDrain{}.Next(sizes);
+    }
+
+private:
+    std::array<uint32_t, Lanes> m_weights{};
+    size_t m_current{0};
+    uint32_t m_credit{0};
+};
+
+// N bounded FIFO lanes behind one blocking consumer interface. Producers block only on their own lane,
+// so a backlog of bulk data never delays a push to the control lane, and the drain policy decides
+// which lane the consumer sees next. FIFO order holds within each lane.
+template<typename T, size_t Lanes, typename DrainPolicy = StrictPriorityDrain>
+class CLaneQueue
+{
+    static_assert(Lanes > 0, "CLaneQueue needs at least one lane");
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+
+    explicit CLaneQueue(size_t laneCapacity = Constants::maxQueueSize, DrainPolicy drain = {})
+        : m_drain(std::move(drain))
+    {
+        m_capacity.fill(laneCapacity ? laneCapacity : std::numeric_limits<size_t>::max());
+    }
+
+    CLaneQueue(const CLaneQueue&) = delete;
+    CLaneQueue& operator=(const CLaneQueue&) = delete;
+    CLaneQueue(CLaneQueue&&) = delete;
+    CLaneQueue& operator=(CLaneQueue&&) = delete;
+
+    [[nodiscard]] static constexpr size_t LaneCount() noexcept { return Lanes; }
+
+    void SetCapacity(size_t lane, size_t cap)
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_capacity[lane] = cap ? cap : std::numeric_limits<size_t>::max();
+        m_notFull[lane].notify_all();
+    }
+
+    void Close()
+    {
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            m_closed = true;
+        }
+        m_notEmpty.notify_all();
+        for (auto& cv : m_notFull)
+        {
+            cv.notify_all();
+        }
+    }
+
+    bool Push(size_t lane, const T& value) { return Emplace(lane, value); }
+    bool Push(size_t lane, T&& value) { return Emplace(lane, std::move(value)); }
+
+    bool TryPush(size_t lane, const T& value) { return DoTryPush(lane, value); }
+    bool TryPush(size_t lane, T&& value) { return DoTryPush(lane, std::move(value)); }
+
+    template<typename... Args>
+    bool Emplace(size_t lane, Args&&... args)
+    {
+        std::unique_lock<std::mutex> lk(m_mutex);
+        m_notFull[lane].wait(lk, [&] { return m_closed || m_lanes[lane].size() < m_capacity[lane]; });
+        if (m_closed)
+        {
+            return false;
+        }
+        m_lanes[lane].emplace_back(std::forward<Args>(args)...);
+        ++m_size;
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    bool PopValue(T& out)
+    {
+        size_t lane = 0;
+        return PopValue(out, lane);
+    }
+
+    // Blocking pop from the lane chosen by the drain policy; reports that lane. Returns false once
+    // closed and every lane is drained.
+    bool PopValue(T& out, size_t& lane)
+    {
+        std::unique_lock<std::mutex> lk(m_mutex);
+        m_notEmpty.wait(lk, [&] { return m_closed || m_size > 0; });
+        return DoPop(out, lane);
+    }
+
+    bool TryPopValue(T& out)
+    {
+        size_t lane = 0;
+        return TryPopValue(out, lane);
+    }
+
+    bool TryPopValue(T& out, size_t& lane)
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        return DoPop(out, lane);
+    }
+
+    [[nodiscard]] bool Empty() const noexcept
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        return m_size == 0;
+    }
+
+    [[nodiscard]] size_type Size() const noexcept
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        return m_size;
+    }
+
+    [[nodiscard]] size_type Size(size_t lane) const noexcept
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        return m_lanes[lane].size();
+    }
+
+private:
+    template<typename U>
+    bool DoTryPush(size_t lane, U&& value)
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        if (m_closed || m_lanes[lane].size() >= m_capacity[lane])
+        {
+            return false;
+        }
+        m_lanes[lane].push_back(std::forward<U>(value));
+        ++m_size;
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    // Caller holds m_mutex.
+    bool DoPop(T& out, size_t& lane)
+    {
+        if (m_size == 0)
+        {
+            return false;
+        }
+        std::array<size_t, Lanes> sizes{};
+        for (size_t i = 0; i < Lanes; ++i)
+        {
+            sizes[i] = m_lanes[i].size();
+        }
+        lane = m_drain.Next(sizes);
+        out = std::move(m_lanes[lane].front());
+        m_lanes[lane].pop_front();
+        --m_size;
+        m_notFull[lane].notify_one();
+        return true;
+    }
+
+    std::array<std::deque<T>, Lanes> m_lanes;
+    std::array<size_t, Lanes> m_capacity{};
+    size_t m_size{0};
+    DrainPolicy m_drain;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::array<std::condition_variable, Lanes> m_notFull;
+    bool m_closed{false};
+};
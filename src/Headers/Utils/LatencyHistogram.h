@@ -0,0 +1,132 @@
+#pragma once
+
+#include "Constants.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Log-linear (HDR-style) latency histogram in fixed memory. Each power of two is split into
+// 2^latencySubBucketBits linear sub-buckets, so any recorded value is reported within ~3%.
+namespace LatencyBuckets
+{
+    constexpr inline size_t subBucketCount = size_t{1} << Constants::latencySubBucketBits;
+    constexpr inline size_t bucketCount = (Constants::latencyMaxBits - Constants::latencySubBucketBits + 1) * subBucketCount;
+    constexpr inline uint64_t maxTrackable = (uint64_t{1} << Constants::latencyMaxBits) - 1;
+
+    constexpr size_t Index(uint64_t value) noexcept
+    {
+        value = std::min(value, maxTrackable);
+        if (value < subBucketCount)
+        {
+            return static_cast<size_t>(value);
+        }
+        auto const shift = static_cast<unsigned>(std::bit_width(value)) - 1 - Constants::latencySubBucketBits;
+        return (shift + 1) * subBucketCount + static_cast<size_t>((value >> shift) - subBucketCount);
+    }
+
+    constexpr uint64_t LowerBound(size_t index) noexcept
+    {
+        if (index < subBucketCount)
+        {
+            return index;
+        }
+        size_t const shift = index / subBucketCount - 1;
+        return (subBucketCount + index % subBucketCount) << shift;
+    }
+
+    constexpr uint64_t UpperBound(size_t index) noexcept
+    {
+        return index < subBucketCount ? index : LowerBound(index) + (uint64_t{1} << (index / subBucketCount - 1)) - 1;
+    }
+} // namespace LatencyBuckets
+
+struct LatencyHistogramSnapshot
+{
+    std::array<uint64_t, LatencyBuckets::bucketCount> m_counts{};
+    uint64_t m_count{};
+    uint64_t m_sum{};
+    uint64_t m_min{std::numeric_limits<uint64_t>::max()};
+    uint64_t m_max{};
+
+    void Merge(const LatencyHistogramSnapshot& other) noexcept
+    {
+        for (size_t i = 0; i < LatencyBuckets::bucketCount; ++i)
+        {
+            m_counts[i] += other.m_counts[i];
+        }
+        m_count += other.m_count;
+        m_sum += other.m_sum;
+        m_min = std::min(m_min, other.m_min);
+        m_max = std::max(m_max, other.m_max);
+    }
+
+    // percentile in [0, 100]; returns the highest value equivalent to the bucket holding it.
+    [[nodiscard]] uint64_t Percentile(double percentile) const noexcept
+    {
+        if (m_count == 0)
+        {
+            return 0;
+        }
+        auto const rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(m_count))));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < LatencyBuckets::bucketCount; ++i)
+        {
+            seen += m_counts[i];
+            if (seen >= rank)
+            {
+                return std::min(LatencyBuckets::UpperBound(i), m_max);
+            }
+        }
+        return m_max;
+    }
+
+    [[nodiscard]] double Mean() const noexcept { return m_count ? static_cast<double>(m_sum) / static_cast<double>(m_count) : 0.0; }
+};
+
+// Single writer records with relaxed load/store pairs (no locked instructions); any thread may take a
+// Snapshot() concurrently. Buckets are individually exact but not captured as one atomic unit.
+class alignas(Constants::cacheLineSize) CLatencyHistogram
+{
+public:
+    void Record(uint64_t valueNs) noexcept
+    {
+        Bump(m_counts[LatencyBuckets::Index(valueNs)], 1);
+        Bump(m_sum, valueNs);
+        if (valueNs < m_min.load(std::memory_order_relaxed))
+        {
+            m_min.store(valueNs, std::memory_order_relaxed);
+        }
+        if (valueNs > m_max.load(std::memory_order_relaxed))
+        {
+            m_max.store(valueNs, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] LatencyHistogramSnapshot Snapshot() const noexcept
+    {
+        LatencyHistogramSnapshot snapshot;
+        for (size_t i = 0; i < LatencyBuckets::bucketCount; ++i)
+        {
+            snapshot.m_counts[i] = m_counts[i].load(std::memory_order_relaxed);
+            snapshot.m_count += snapshot.m_counts[i];
+        }
+        snapshot.m_sum = m_sum.load(std::memory_order_relaxed);
+        snapshot.m_min = m_min.load(std::memory_order_relaxed);
+        snapshot.m_max = m_max.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+private:
+    static void Bump(std::atomic<uint64_t>& counter, uint64_t delta) noexcept { counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed); }
+
+    std::array<std::atomic<uint64_t>, LatencyBuckets::bucketCount> m_counts{};
+    std::atomic<uint64_t> m_sum{0};
+    std::atomic<uint64_t> m_min{std::numeric_limits<uint64_t>::max()};
+    std::atomic<uint64_t> m_max{0};
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+// Memory mapping of a whole file, read-only or shared read-write. Pages are faulted in from the page
+// cache as they are touched, so reading a large file costs no copy into user buffers; sequential access
+// is hinted to the kernel. Release() drops pages already consumed, which keeps a single pass over a file
+// larger than memory at a bounded resident size. An empty file opens with an empty view.
+// Writes through a writable mapping reach the page cache directly and survive a crash of the process;
+// Sync() is only needed to survive a crash of the machine.
+class CMappedFile
+{
+public:
+    CMappedFile() = default;
+    ~CMappedFile() { Close(); }
+
+    CMappedFile(const CMappedFile&) = delete;
+    CMappedFile& operator=(const CMappedFile&) = delete;
+    CMappedFile(CMappedFile&&) = delete;
+    CMappedFile& operator=(CMappedFile&&) = delete;
+
+    bool Open(const std::string& path);
+    // Maps path shared and writable, creating it or growing it to at least size bytes; grown bytes
+    // read as zero.
+    bool OpenWritable(const std::string& path, size_t size);
+    void Close();
+
+    // Writes the dirty pages of [offset, offset + length) back to the file; wait blocks until done.
+    bool Sync(size_t offset, size_t length, bool wait) noexcept;
+
+    // Gives back the resident pages wholly before offset. The view stays valid; those bytes are read
+    // from the file again if touched.
+    void Release(size_t offset) noexcept;
+
+    [[nodiscard]] std::span<const uint8_t> Bytes() const noexcept { return {m_data, m_size}; }
+    // Empty unless opened with OpenWritable().
+    [[nodiscard]] std::span<uint8_t> MutableBytes() noexcept { return m_writable ? std::span<uint8_t>(m_data, m_size) : std::span<uint8_t>(); }
+    [[nodiscard]] std::string_view Text() const noexcept { return {reinterpret_cast<const char*>(m_data), m_size}; }
+    [[nodiscard]] size_t Size() const noexcept { return m_size; }
+    [[nodiscard]] bool IsOpen() const noexcept { return m_fd >= 0; }
+    [[nodiscard]] bool IsWritable() const noexcept { return m_writable; }
+
+private:
+    bool Map(int fd, size_t size, bool writable);
+
+    int m_fd{-1};
+    uint8_t* m_data{nullptr};
+    size_t m_size{0};
+    size_t m_released{0};
+    bool m_writable{false};
+};
@@ -0,0 +1,406 @@
+#pragma once
+
+#include "Constants.h"
+#include "Utils/EventCount.h"
+#include "Utils/Queue.h"
+#include "Utils/QueueMetrics.h"
+#include "Utils/Trace.h"
+#include "Utils/WaitPolicy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+
+// Backend tag for a bounded lock-free multi-producer/multi-consumer ring: CQueue<T, MpmcRing[, WaitPolicy[, Metrics]]>
+// Cells carry a sequence number (Vyukov's bounded MPMC design), so producers and consumers only
+// contend on their own position counter and never on each other.
+struct MpmcRing
+{
+};
+
+template<typename T, typename WaitPolicy, typename Metrics>
+class CQueue<T, MpmcRing, WaitPolicy, Metrics>
+{
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+    CQueue()
+        : CQueue(Constants::maxQueueSize)
+    {
+    }
+    explicit CQueue(size_t capacity)
+        : m_mask(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1)
+        , m_cells(std::make_unique<Cell[]>(m_mask + 1))
+    {
+        for (size_t i = 0; i <= m_mask; ++i)
+        {
+            m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    CQueue(const CQueue&) = delete;
+    CQueue& operator=(const CQueue&) = delete;
+    CQueue(CQueue&&) = delete;
+    CQueue& operator=(CQueue&&) = delete;
+
+    ~CQueue()
+    {
+        while (Dequeue())
+        {
+        }
+    }
+
+    void Close()
+    {
+        m_closed.store(true, std::memory_order_seq_cst);
+        m_notEmpty.NotifyAll();
+        m_notFull.NotifyAll();
+        NotifyListener();
+    }
+
+    // Also signals notifier on every push and on Close(), so one consumer can wait on several queues
+    // (CQueueSelect, Utils/QueueSelect.h). Set before producers start. Replacing or detaching (nullptr)
+    // waits for producers still signalling the previous notifier, which may be destroyed once this
+    // returns.
+    void SetNotifier(CEventCount* notifier) noexcept
+    {
+        m_notifier.store(notifier, std::memory_order_seq_cst);
+        while (m_notifying.load(std::memory_order_seq_cst) != 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // BLOCK, DROP_NEWEST, DROP_OLDEST and SAMPLE; a producer evicts the front element itself, as any
+    // consumer would. Returns false (and changes nothing) for EVICT, which needs to scan the queue.
+    bool SetOverflowPolicy(OverflowPolicy policy, size_t sampleEvery = 1) noexcept
+    {
+        if (policy == OverflowPolicy::EVICT)
+        {
+            return false;
+        }
+        m_sampleEvery.store(sampleEvery ? sampleEvery : 1, std::memory_order_relaxed);
+        m_overflow.store(policy, std::memory_order_release);
+        m_notFull.NotifyAll();
+        return true;
+    }
+
+    bool Push(const T& value) { return Emplace(value); }
+    bool Push(T&& value) { return Emplace(std::move(value)); }
+
+    bool TryPush(const T& value) { return TryEmplace(value); }
+    bool TryPush(T&& value) { return TryEmplace(std::move(value)); }
+
+    template<typename... Args>
+    bool Emplace(Args&&... args)
+    {
+        while (true)
+        {
+            if (!BeginPush())
+            {
+                return false;
+            }
+            bool const pushed = Enqueue(std::forward<Args>(args)...);
+            EndPush();
+            if (pushed)
+            {
+                m_notEmpty.NotifyOne();
+                NotifyListener();
+                return true;
+            }
+            if (!Overflow())
+            {
+                return true;
+            }
+        }
+    }
+
+    void Pop()
+    {
+        while (!Dequeue())
+        {
+            if (!WaitForItem())
+            {
+                return;
+            }
+        }
+        m_notFull.NotifyOne();
+    }
+
+    // Another consumer may win the element we were woken for, so retry until one is ours or the
+    // queue is closed and drained.
+    bool PopValue(T& out)
+    {
+        while (!Dequeue(&out))
+        {
+            if (!WaitForItem())
+            {
+                return false;
+            }
+        }
+        m_notFull.NotifyOne();
+        return true;
+    }
+
+    bool TryPopValue(T& out)
+    {
+        if (!Dequeue(&out))
+        {
+            return false;
+        }
+        m_notFull.NotifyOne();
+        return true;
+    }
+
+    [[nodiscard]] bool Empty() const noexcept { return Size() == 0; }
+
+    // Snapshot; may be stale by the time it returns.
+    [[nodiscard]] size_type Size() const noexcept
+    {
+        size_t const head = m_dequeuePos.load(std::memory_order_acquire);
+        size_t const tail = m_enqueuePos.load(std::memory_order_acquire);
+        return std::min(tail - head, Capacity());
+    }
+
+    [[nodiscard]] size_type Capacity() const noexcept { return m_mask + 1; }
+
+    // Closed, and every push that passed the closed check before Close() is in the ring, so an Empty()
+    // read afterwards is final.
+    [[nodiscard]] bool Closed() const noexcept { return m_closed.load(std::memory_order_seq_cst) && m_pushing.load(std::memory_order_seq_cst) == 0; }
+
+    // Lock-free; Snapshot() is all zeros unless Metrics is CQueueMetrics.
+    [[nodiscard]] const Metrics& GetMetrics() const noexcept { return m_metrics; }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> m_sequence;
+        alignas(T) std::byte m_storage[sizeof(T)];
+        [[no_unique_address]] typename Metrics::Stamp m_stamp;
+    };
+
+    // The ring was full. Returns true to retry the push: after waiting for space under BLOCK, or after
+    // evicting the front element. Returns false once the incoming element is counted as dropped.
+    bool Overflow()
+    {
+        switch (m_overflow.load(std::memory_order_acquire))
+        {
+        case OverflowPolicy::BLOCK:
+            WaitNotFull([&] { return m_closed.load(std::memory_order_acquire) || Size() < Capacity() || m_overflow.load(std::memory_order_acquire) != OverflowPolicy::BLOCK; });
+            return true;
+        case OverflowPolicy::SAMPLE:
+            if ((m_overflowCount.fetch_add(1, std::memory_order_relaxed) + 1) % m_sampleEvery.load(std::memory_order_relaxed) != 0)
+            {
+                break;
+            }
+            [[fallthrough]];
+        case OverflowPolicy::DROP_OLDEST:
+            // A consumer may have made room meanwhile; either way the retry finds a free cell or another full ring.
+            Dequeue(nullptr, true);
+            return true;
+        default:
+            break;
+        }
+        m_metrics.OnDrop();
+        return false;
+    }
+
+    template<typename... Args>
+    bool TryEmplace(Args&&... args)
+    {
+        if (!BeginPush())
+        {
+            return false;
+        }
+        bool const pushed = Enqueue(std::forward<Args>(args)...);
+        EndPush();
+        if (!pushed)
+        {
+            return false;
+        }
+        m_notEmpty.NotifyOne();
+        NotifyListener();
+        return true;
+    }
+
+    template<typename... Args>
+    bool Enqueue(Args&&... args)
+    {
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        while (true)
+        {
+            cell = &m_cells[pos & m_mask];
+            size_t const sequence = cell->m_sequence.load(std::memory_order_acquire);
+            auto const diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        ::new (static_cast<void*>(cell->m_storage)) T(std::forward<Args>(args)...);
+        cell->m_stamp = Metrics::Now();
+        cell->m_sequence.store(pos + 1, std::memory_order_release);
+        if constexpr (Metrics::enabled)
+        {
+            m_metrics.OnPush(Size());
+        }
+        return true;
+    }
+
+    // Moves the front element into *out, or discards it when out is null. evict counts the discard as
+    // an overflow eviction rather than a pop.
+    bool Dequeue(T* out = nullptr, bool evict = false)
+    {
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        while (true)
+        {
+            cell = &m_cells[pos & m_mask];
+            size_t const sequence = cell->m_sequence.load(std::memory_order_acquire);
+            auto const diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        T* item = std::launder(reinterpret_cast<T*>(cell->m_storage));
+        if (out)
+        {
+            *out = std::move(*item);
+        }
+        item->~T();
+        if (evict)
+        {
+            m_metrics.OnEvict(cell->m_stamp);
+        }
+        else
+        {
+            m_metrics.OnPop(cell->m_stamp);
+        }
+        cell->m_sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Counted in m_pushing from the closed check until the element is in the ring. Store-load pairing
+    // with Closed(): either the load here sees m_closed, or Closed() sees the count and reports the
+    // queue open until EndPush().
+    bool BeginPush() noexcept
+    {
+        m_pushing.fetch_add(1, std::memory_order_seq_cst);
+        if (!m_closed.load(std::memory_order_seq_cst))
+        {
+            return true;
+        }
+        EndPush();
+        return false;
+    }
+
+    void EndPush() noexcept
+    {
+        m_pushing.fetch_sub(1, std::memory_order_seq_cst);
+        if (m_closed.load(std::memory_order_seq_cst))
+        {
+            // A consumer may have found the queue closed but this push still counted; it looks again.
+            m_notEmpty.NotifyAll();
+            NotifyListener();
+        }
+    }
+
+    // Counted in m_notifying while the notifier is in use, so SetNotifier() can wait it out. Store-load
+    // pairing with SetNotifier: either the load here sees the new notifier or SetNotifier sees the count.
+    void NotifyListener() noexcept
+    {
+        if (m_notifier.load(std::memory_order_relaxed) == nullptr)
+        {
+            return;
+        }
+        m_notifying.fetch_add(1, std::memory_order_seq_cst);
+        if (CEventCount* notifier = m_notifier.load(std::memory_order_seq_cst))
+        {
+            notifier->NotifyAll();
+        }
+        m_notifying.fetch_sub(1, std::memory_order_release);
+    }
+
+    template<typename Ready>
+    void WaitNotFull(Ready ready)
+    {
+        if (ready())
+        {
+            return;
+        }
+        TWIZ_TRACE_SCOPE("CQueue::WaitNotFull");
+        auto const start = Metrics::Now();
+        WaitPolicy::Wait(m_notFull, ready);
+        m_metrics.OnFullWait(start);
+    }
+
+    template<typename Ready>
+    void WaitNotEmpty(Ready ready)
+    {
+        if (ready())
+        {
+            return;
+        }
+        TWIZ_TRACE_SCOPE("CQueue::WaitNotEmpty");
+        auto const start = Metrics::Now();
+        WaitPolicy::Wait(m_notEmpty, ready);
+        m_metrics.OnEmptyWait(start);
+    }
+
+    // Returns false once the queue is closed and drained, true when an element may be available.
+    bool WaitForItem()
+    {
+        WaitNotEmpty([&] { return !Empty() || Closed(); });
+        return !Empty();
+    }
+
+    alignas(Constants::cacheLineSize) std::atomic<size_t> m_enqueuePos{0};
+    std::atomic<uint32_t> m_pushing{0}; // pushes between the closed check and the ring
+    alignas(Constants::cacheLineSize) std::atomic<size_t> m_dequeuePos{0};
+
+    alignas(Constants::cacheLineSize) const size_t m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+    std::atomic<bool> m_closed{false};
+    std::atomic<CEventCount*> m_notifier{nullptr};
+    std::atomic<uint32_t> m_notifying{0}; // producers inside NotifyListener()
+    std::atomic<OverflowPolicy> m_overflow{OverflowPolicy::BLOCK};
+    std::atomic<size_t> m_sampleEvery{1};
+    std::atomic<size_t> m_overflowCount{0};
+
+    alignas(Constants::cacheLineSize) CEventCount m_notEmpty;
+    alignas(Constants::cacheLineSize) CEventCount m_notFull;
+    [[no_unique_address]] Metrics m_metrics;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+struct PerfCounterValues
+{
+    uint64_t m_cycles{};
+    uint64_t m_instructions{};
+    uint64_t m_llcMisses{};
+    uint64_t m_branchMisses{};
+    uint64_t m_contextSwitches{};
+};
+
+// Per-thread hardware counter group backed by perf_event_open: cycles, instructions, last-level cache
+// misses, branch misses and context switches for the calling thread, user space only. Counters the
+// kernel or CPU refuses (perf_event_paranoid, VMs without a PMU) are left out and read as zero;
+// Open() fails only when none is available. Values are scaled if the kernel multiplexed the group.
+class CPerfCounters
+{
+public:
+    CPerfCounters() = default;
+    ~CPerfCounters() { Close(); }
+
+    CPerfCounters(const CPerfCounters&) = delete;
+    CPerfCounters& operator=(const CPerfCounters&) = delete;
+    CPerfCounters(CPerfCounters&&) = delete;
+    CPerfCounters& operator=(CPerfCounters&&) = delete;
+
+    // Call on the thread to be measured.
+    bool Open();
+    void Close();
+    // One read() for the whole group. Cumulative since Open().
+    bool Read(PerfCounterValues& out) const;
+
+    [[nodiscard]] bool IsOpen() const noexcept { return m_leader >= 0; }
+
+private:
+    enum Counter : size_t
+    {
+        CYCLES = 0,
+        INSTRUCTIONS,
+        LLC_MISSES,
+        BRANCH_MISSES,
+        CONTEXT_SWITCHES,
+        COUNTER_COUNT
+    };
+
+    int m_leader{-1};
+    std::array<int, COUNTER_COUNT> m_fds{-1, -1, -1, -1, -1};
+    // Position of each counter in the group read, or -1 when it could not be opened.
+    std::array<int, COUNTER_COUNT> m_slots{-1, -1, -1, -1, -1};
+    size_t m_members{0};
+};
@@ -1,11 +1,37 @@
 #pragma once
 
+#include "Utils/EventCount.h"
+#include "Utils/QueueMetrics.h"
+#include "Utils/Trace.h"
+#include "Utils/WaitPolicy.h"
+
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
 #include <limits>
 #include <mutex>
+#include <optional>
 #include <queue>
+#include <ranges>
+#include <type_traits>
+
+// What a blocking push (Push, Emplace, PushBulk) does when a bounded queue is full. TryPush is not
+// affected: it still fails, so the caller keeps its own fallback. Discarded elements are counted by
+// the Metrics policy (m_drops for incoming elements, m_evictions for queued ones).
+enum class OverflowPolicy : uint8_t
+{
+    BLOCK,       // wait for space (default)
+    DROP_NEWEST, // discard the incoming element
+    DROP_OLDEST, // discard the front element to make room
+    SAMPLE,      // admit every Nth overflowing element by discarding the front one, discard the rest
+    EVICT        // discard the lowest-priority element, queued or incoming (SetEvictionPriority)
+};
 
-template<typename T, typename Container = std::deque<T>>
+template<typename T, typename Container = std::deque<T>, typename WaitPolicy = ParkWait, typename Metrics = NoQueueMetrics>
 class CQueue
 {
 public:
@@ -22,10 +48,12 @@ public:
     explicit CQueue(const Container& cont)
         : m_queue(cont)
     {
+        StampExisting();
     }
     explicit CQueue(Container&& cont)
         : m_queue(std::move(cont))
     {
+        StampExisting();
     }
 
     CQueue(const CQueue&) = delete;
@@ -40,16 +68,54 @@ public:
         m_notFull.notify_all();
     }
 
+    // sampleEvery applies to SAMPLE. Returns false (and changes nothing) for EVICT without an
+    // eviction priority.
+    bool SetOverflowPolicy(OverflowPolicy policy, size_t sampleEvery = 1)
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        if (policy == OverflowPolicy::EVICT && !m_priority)
+        {
+            return false;
+        }
+        m_overflow = policy;
+        m_sampleEvery = sampleEvery ? sampleEvery : 1;
+        m_overflowCount = 0;
+        // Producers waiting under BLOCK re-check and apply the new policy.
+        m_notFull.notify_all();
+        return true;
+    }
+
+    // Selects EVICT: on overflow the element with the lowest priority(element) is discarded, the
+    // oldest among equals, unless the incoming element ranks lower still. Scans the queue under the
+    // lock, so it suits queues that only overflow under load.
+    void SetEvictionPriority(std::function<int64_t(const T&)> priority)
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_priority = std::move(priority);
+        m_overflow = m_priority ? OverflowPolicy::EVICT : OverflowPolicy::BLOCK;
+        m_notFull.notify_all();
+    }
+
     void Close()
     {
         {
             std::lock_guard<std::mutex> lk(m_mutex);
             m_closed = true;
+            NotifyListener();
         }
         m_notEmpty.notify_all();
         m_notFull.notify_all();
     }
 
+    // Also signals notifier on every push and on Close(), so one consumer can wait on several queues
+    // (CQueueSelect, Utils/QueueSelect.h). Set before producers start; nullptr detaches. Signalling
+    // happens under the lock taken here, so the previous notifier is unused once this returns.
+    void SetNotifier(CEventCount* notifier)
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_notifier = notifier;
+    }
+
     bool Push(const T& value) { return DoPush(value); }
     bool Push(T&& value) { return DoPush(std::move(value)); }
 
@@ -60,38 +126,121 @@ public:
     bool Emplace(Args&&... args)
     {
         std::unique_lock<std::mutex> lk(m_mutex);
-        m_notFull.wait(lk, [&] { return m_closed || m_queue.size() < m_capacity; });
-        if (m_closed)
+        if (m_overflow == OverflowPolicy::EVICT)
         {
-            return false;
+            // Eviction ranks the incoming element too, so it has to exist first.
+            return PushLocked(lk, T(std::forward<Args>(args)...));
+        }
+        if (!MakeRoom(lk, nullptr))
+        {
+            return !m_closed;
         }
         m_queue.emplace(std::forward<Args>(args)...);
+        OnPushed();
         m_notEmpty.notify_one();
+        NotifyListener();
         return true;
     }
 
+    // Pushes the whole range, blocking while the queue is full (or applying the overflow policy).
+    // Each time the lock is taken, as many elements as fit are pushed and consumers are woken once.
+    // Returns the number taken from the range, including any the overflow policy discarded, which is
+    // short of the range only if the queue was closed.
+    template<std::input_iterator It, std::sentinel_for<It> Sentinel>
+    size_t PushBulk(It first, Sentinel last)
+    {
+        size_t pushed = 0;
+        std::unique_lock<std::mutex> lk(m_mutex);
+        while (first != last)
+        {
+            WaitNotFull(lk, [&] { return m_closed || m_queue.size() < m_capacity || m_overflow != OverflowPolicy::BLOCK; });
+            if (m_closed)
+            {
+                break;
+            }
+            size_t batch = 0;
+            for (; first != last && m_queue.size() < m_capacity; ++first, ++batch)
+            {
+                m_queue.push(*first);
+                OnPushed();
+            }
+            pushed += batch;
+            // Still full: every further element goes through the overflow policy.
+            for (; first != last && m_overflow != OverflowPolicy::BLOCK; ++first, ++pushed)
+            {
+                T value(*first);
+                if (Overflow(&value))
+                {
+                    m_queue.push(std::move(value));
+                    OnPushed();
+                    ++batch;
+                }
+            }
+            NotifyBatch(m_notEmpty, batch);
+            if (batch)
+            {
+                NotifyListener();
+            }
+        }
+        return pushed;
+    }
+
+    template<std::ranges::input_range Range>
+    size_t PushBulk(Range&& range)
+    {
+        return PushBulk(std::ranges::begin(range), std::ranges::end(range));
+    }
+
+    // Blocks until at least one element is available, then moves up to maxCount elements to out
+    // under a single lock acquisition. Returns 0 only once the queue is closed and drained.
+    template<typename OutputIt>
+    size_t PopBulk(OutputIt out, size_t maxCount)
+    {
+        std::unique_lock<std::mutex> lk(m_mutex);
+        WaitNotEmpty(lk, [&] { return m_closed || !m_queue.empty(); });
+        return DrainTo(out, maxCount);
+    }
+
+    // As PopBulk, but gives up after timeout. Returns 0 on timeout or once closed and drained.
+    template<typename OutputIt, typename Rep, typename Period>
+    size_t PopBulkFor(OutputIt out, size_t maxCount, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        auto const ready = [&] { return m_closed || !m_queue.empty(); };
+        std::unique_lock<std::mutex> lk(m_mutex);
+        if (!ready())
+        {
+            TWIZ_TRACE_SCOPE("CQueue::WaitNotEmpty");
+            auto const start = Metrics::Now();
+            m_notEmpty.wait_for(lk, timeout, ready);
+            m_metrics.OnEmptyWait(start);
+        }
+        return DrainTo(out, maxCount);
+    }
+
     void Pop()
     {
         std::unique_lock<std::mutex> lk(m_mutex);
-        m_notEmpty.wait(lk, [&] { return m_closed || !m_queue.empty(); });
+        WaitNotEmpty(lk, [&] { return m_closed || !m_queue.empty(); });
         if (m_queue.empty())
         {
             return;
         }
         m_queue.pop();
+        OnPopped();
         m_notFull.notify_one();
     }
 
     bool PopValue(T& out)
     {
         std::unique_lock<std::mutex> lk(m_mutex);
-        m_notEmpty.wait(lk, [&] { return m_closed || !m_queue.empty(); });
+        WaitNotEmpty(lk, [&] { return m_closed || !m_queue.empty(); });
         if (m_queue.empty())
         {
             return false;
         }
         out = std::move(m_queue.front());
         m_queue.pop();
+        OnPopped();
         m_notFull.notify_one();
         return true;
     }
@@ -105,6 +254,7 @@ public:
         }
         out = std::move(m_queue.front());
         m_queue.pop();
+        OnPopped();
         m_notFull.notify_one();
         return true;
     }
@@ -112,14 +262,14 @@ public:
     [[nodiscard]] reference Front()
     {
         std::unique_lock<std::mutex> lk(m_mutex);
-        m_notEmpty.wait(lk, [&] { return m_closed || !m_queue.empty(); });
+        WaitNotEmpty(lk, [&] { return m_closed || !m_queue.empty(); });
         return m_queue.front();
     }
 
     [[nodiscard]] const_reference Front() const
     {
         std::unique_lock<std::mutex> lk(m_mutex);
-        const_cast<CQueue*>(this)->m_notEmpty.wait(lk, [&] { return m_closed || !m_queue.empty(); });
+        const_cast<CQueue*>(this)->WaitNotEmpty(lk, [&] { return m_closed || !m_queue.empty(); });
         return m_queue.front();
     }
 
@@ -135,18 +285,236 @@ public:
         return m_queue.size();
     }
 
+    // Lock-free: the size as of the last push or pop, for monitoring from other threads (the ring
+    // backends' Size() already is). Use Size() when the exact value matters.
+    [[nodiscard]] size_type ApproxSize() const noexcept { return m_size.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] bool Closed() const noexcept
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        return m_closed;
+    }
+
+    // Lock-free; Snapshot() is all zeros unless Metrics is CQueueMetrics.
+    [[nodiscard]] const Metrics& GetMetrics() const noexcept { return m_metrics; }
+
 private:
+    // std::queue with its container exposed, so overflow eviction can reach past the front.
+    template<typename Q>
+    struct Storage : Q
+    {
+        using Q::c;
+    };
+
+    // Per-element enqueue stamps for the dwell histogram, kept in step with m_queue. Empty unless instrumented.
+    using StampQueue = std::conditional_t<Metrics::enabled, Storage<std::queue<typename Metrics::Stamp>>, typename NoQueueMetrics::Stamp>;
+
+    // Caller holds m_mutex for the helpers below.
+    template<typename Ready>
+    void WaitNotFull(std::unique_lock<std::mutex>& lk, Ready ready)
+    {
+        if (ready())
+        {
+            return;
+        }
+        TWIZ_TRACE_SCOPE("CQueue::WaitNotFull");
+        auto const start = Metrics::Now();
+        WaitPolicy::Wait(lk, m_notFull, ready);
+        m_metrics.OnFullWait(start);
+    }
+
+    // Returns true once there is room for the incoming element. False means the queue is closed or
+    // the overflow policy discarded the element; callers tell them apart by m_closed. incoming is
+    // only needed (and only non-null) under EVICT.
+    bool MakeRoom(std::unique_lock<std::mutex>& lk, const T* incoming)
+    {
+        WaitNotFull(lk, [&] { return m_closed || m_queue.size() < m_capacity || m_overflow != OverflowPolicy::BLOCK; });
+        if (m_closed)
+        {
+            return false;
+        }
+        return m_queue.size() < m_capacity || Overflow(incoming);
+    }
+
+    // The queue is full and the policy is not BLOCK. Discards a queued element and returns true, or
+    // counts the incoming one as dropped and returns false.
+    bool Overflow(const T* incoming)
+    {
+        if (m_queue.empty())
+        {
+            m_metrics.OnDrop();
+            return false;
+        }
+        switch (m_overflow)
+        {
+        case OverflowPolicy::DROP_OLDEST:
+            Evict(0);
+            return true;
+        case OverflowPolicy::SAMPLE:
+            if (++m_overflowCount % m_sampleEvery == 0)
+            {
+                Evict(0);
+                return true;
+            }
+            break;
+        case OverflowPolicy::EVICT:
+            // incoming is null if the policy switched to EVICT while this push waited; it is dropped.
+            if (std::optional<size_t> const victim = incoming ? PickVictim(*incoming) : std::nullopt)
+            {
+                Evict(*victim);
+                return true;
+            }
+            break;
+        default:
+            break;
+        }
+        m_metrics.OnDrop();
+        return false;
+    }
+
+    [[nodiscard]] std::optional<size_t> PickVictim(const T& incoming) const
+    {
+        std::optional<size_t> victim;
+        int64_t lowest = m_priority(incoming);
+        size_t index = 0;
+        for (const T& queued : m_queue.c)
+        {
+            int64_t const priority = m_priority(queued);
+            if (priority < lowest)
+            {
+                lowest = priority;
+                victim = index;
+            }
+            ++index;
+        }
+        return victim;
+    }
+
+    void Evict(size_t index)
+    {
+        m_queue.c.erase(std::next(m_queue.c.begin(), static_cast<std::ptrdiff_t>(index)));
+        if constexpr (Metrics::enabled)
+        {
+            auto const stamp = std::next(m_stamps.c.begin(), static_cast<std::ptrdiff_t>(index));
+            m_metrics.OnEvict(*stamp);
+            m_stamps.c.erase(stamp);
+        }
+        PublishSize();
+    }
+
+    template<typename Ready>
+    void WaitNotEmpty(std::unique_lock<std::mutex>& lk, Ready ready)
+    {
+        if (ready())
+        {
+            return;
+        }
+        TWIZ_TRACE_SCOPE("CQueue::WaitNotEmpty");
+        auto const start = Metrics::Now();
+        WaitPolicy::Wait(lk, m_notEmpty, ready);
+        m_metrics.OnEmptyWait(start);
+    }
+
+    void NotifyListener()
+    {
+        if (m_notifier)
+        {
+            m_notifier->NotifyAll();
+        }
+    }
+
+    void OnPushed()
+    {
+        if constexpr (Metrics::enabled)
+        {
+            m_stamps.push(Metrics::Now());
+        }
+        m_metrics.OnPush(m_queue.size());
+        PublishSize();
+    }
+
+    void OnPopped()
+    {
+        if constexpr (Metrics::enabled)
+        {
+            m_metrics.OnPop(m_stamps.front());
+            m_stamps.pop();
+        }
+        PublishSize();
+    }
+
+    void StampExisting()
+    {
+        if constexpr (Metrics::enabled)
+        {
+            for (size_t i = 0; i < m_queue.size(); ++i)
+            {
+                m_stamps.push(Metrics::Now());
+            }
+        }
+        PublishSize();
+    }
+
+    void PublishSize() { m_size.store(m_queue.size(), std::memory_order_relaxed); }
+
+    template<typename OutputIt>
+    size_t DrainTo(OutputIt& out, size_t maxCount)
+    {
+        size_t count = 0;
+        for (; count < maxCount && !m_queue.empty(); ++count)
+        {
+            *out = std::move(m_queue.front());
+            ++out;
+            m_queue.pop();
+            OnPopped();
+        }
+        NotifyBatch(m_notFull, count);
+        return count;
+    }
+
+    // One wakeup per batch: a single waiter for a single element, everyone for more, so that
+    // element-wise waiters on the other side are not left asleep with work available.
+    static void NotifyBatch(std::condition_variable& cv, size_t count)
+    {
+        if (count == 1)
+        {
+            cv.notify_one();
+        }
+        else if (count > 1)
+        {
+            cv.notify_all();
+        }
+    }
+
     template<typename U>
     bool DoPush(U&& value)
     {
         std::unique_lock<std::mutex> lk(m_mutex);
-        m_notFull.wait(lk, [&] { return m_closed || m_queue.size() < m_capacity; });
-        if (m_closed)
+        if (m_overflow == OverflowPolicy::EVICT)
         {
-            return false;
+            return PushLocked(lk, T(std::forward<U>(value)));
+        }
+        if (!MakeRoom(lk, nullptr))
+        {
+            return !m_closed;
         }
         m_queue.push(std::forward<U>(value));
+        OnPushed();
+        m_notEmpty.notify_one();
+        NotifyListener();
+        return true;
+    }
+
+    bool PushLocked(std::unique_lock<std::mutex>& lk, T&& value)
+    {
+        if (!MakeRoom(lk, &value))
+        {
+            return !m_closed;
+        }
+        m_queue.push(std::move(value));
+        OnPushed();
         m_notEmpty.notify_one();
+        NotifyListener();
         return true;
     }
 
@@ -159,14 +527,24 @@ private:
             return false;
         }
         m_queue.push(std::forward<U>(value));
+        OnPushed();
         m_notEmpty.notify_one();
+        NotifyListener();
         return true;
     }
 
     size_t m_capacity{std::numeric_limits<size_t>::max()};
-    std::queue<T, Container> m_queue;
+    Storage<std::queue<T, Container>> m_queue;
+    std::atomic<size_t> m_size{0}; // m_queue.size() mirrored for ApproxSize()
     mutable std::mutex m_mutex;
     std::condition_variable m_notEmpty;
     std::condition_variable m_notFull;
     bool m_closed{false};
+    CEventCount* m_notifier{nullptr};
+    OverflowPolicy m_overflow{OverflowPolicy::BLOCK};
+    size_t m_sampleEvery{1};
+    size_t m_overflowCount{0};
+    std::function<int64_t(const T&)> m_priority;
+    [[no_unique_address]] StampQueue m_stamps;
+    [[no_unique_address]] Metrics m_metrics;
 };
\ No newline at end of file
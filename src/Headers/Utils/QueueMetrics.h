@@ -0,0 +1,130 @@
+#pragma once
+
+#include "Constants.h"
+#include "Utils/Clock.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// Instrumentation policies for CQueue's Metrics parameter.
+// NoQueueMetrics (default) compiles every hook away; CQueueMetrics keeps relaxed atomic counters that
+// any thread can read through Snapshot() without touching the queue's lock.
+
+struct QueueMetricsSnapshot
+{
+    uint64_t m_pushes{};
+    uint64_t m_pops{};
+    uint64_t m_fullBlocks{};
+    uint64_t m_emptyBlocks{};
+    uint64_t m_fullWaitNs{};
+    uint64_t m_emptyWaitNs{};
+    uint64_t m_highWaterMark{};
+    uint64_t m_drops{};     // incoming elements discarded by the overflow policy
+    uint64_t m_evictions{}; // queued elements discarded to make room
+    // Bucket i counts elements that waited in the queue for [2^(i-1), 2^i) ns; bucket 0 is < 1 ns.
+    std::array<uint64_t, Constants::queueDwellBuckets> m_dwellHistogramNs{};
+    uint64_t m_dwellSumNs{}; // total dwell of the elements counted in m_dwellHistogramNs
+};
+
+struct NoQueueMetrics
+{
+    struct Stamp
+    {
+    };
+    static constexpr bool enabled = false;
+
+    static Stamp Now() noexcept { return {}; }
+    void OnPush(size_t /*sizeAfter*/) noexcept {}
+    void OnPop(Stamp /*enqueued*/) noexcept {}
+    void OnFullWait(Stamp /*start*/) noexcept {}
+    void OnEmptyWait(Stamp /*start*/) noexcept {}
+    void OnDrop() noexcept {}
+    void OnEvict(Stamp /*enqueued*/) noexcept {}
+    [[nodiscard]] QueueMetricsSnapshot Snapshot() const noexcept { return {}; }
+};
+
+class alignas(Constants::cacheLineSize) CQueueMetrics
+{
+public:
+    using Stamp = uint64_t;
+    static constexpr bool enabled = true;
+
+    static Stamp Now() noexcept
+    {
+        return Utils::GetTickCountNanos();
+    }
+
+    void OnPush(size_t sizeAfter) noexcept
+    {
+        m_pushes.fetch_add(1, std::memory_order_relaxed);
+        uint64_t highWater = m_highWaterMark.load(std::memory_order_relaxed);
+        while (sizeAfter > highWater && !m_highWaterMark.compare_exchange_weak(highWater, sizeAfter, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void OnPop(Stamp enqueued) noexcept
+    {
+        m_pops.fetch_add(1, std::memory_order_relaxed);
+        Stamp const now = Now();
+        uint64_t const dwell = now > enqueued ? now - enqueued : 0;
+        size_t const bucket = std::min<size_t>(std::bit_width(dwell), Constants::queueDwellBuckets - 1);
+        m_dwellHistogramNs[bucket].fetch_add(1, std::memory_order_relaxed);
+        m_dwellSumNs.fetch_add(dwell, std::memory_order_relaxed);
+    }
+
+    void OnFullWait(Stamp start) noexcept
+    {
+        m_fullBlocks.fetch_add(1, std::memory_order_relaxed);
+        m_fullWaitNs.fetch_add(Now() - start, std::memory_order_relaxed);
+    }
+
+    void OnEmptyWait(Stamp start) noexcept
+    {
+        m_emptyBlocks.fetch_add(1, std::memory_order_relaxed);
+        m_emptyWaitNs.fetch_add(Now() - start, std::memory_order_relaxed);
+    }
+
+    void OnDrop() noexcept { m_drops.fetch_add(1, std::memory_order_relaxed); }
+
+    // Evicted elements leave without a pop, so they stay out of the dwell histogram.
+    void OnEvict(Stamp /*enqueued*/) noexcept { m_evictions.fetch_add(1, std::memory_order_relaxed); }
+
+    // Each counter is individually exact; counters are not read as one atomic unit.
+    [[nodiscard]] QueueMetricsSnapshot Snapshot() const noexcept
+    {
+        QueueMetricsSnapshot snapshot;
+        snapshot.m_pushes = m_pushes.load(std::memory_order_relaxed);
+        snapshot.m_pops = m_pops.load(std::memory_order_relaxed);
+        snapshot.m_fullBlocks = m_fullBlocks.load(std::memory_order_relaxed);
+        snapshot.m_emptyBlocks = m_emptyBlocks.load(std::memory_order_relaxed);
+        snapshot.m_fullWaitNs = m_fullWaitNs.load(std::memory_order_relaxed);
+        snapshot.m_emptyWaitNs = m_emptyWaitNs.load(std::memory_order_relaxed);
+        snapshot.m_highWaterMark = m_highWaterMark.load(std::memory_order_relaxed);
+        snapshot.m_drops = m_drops.load(std::memory_order_relaxed);
+        snapshot.m_evictions = m_evictions.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < Constants::queueDwellBuckets; ++i)
+        {
+            snapshot.m_dwellHistogramNs[i] = m_dwellHistogramNs[i].load(std::memory_order_relaxed);
+        }
+        snapshot.m_dwellSumNs = m_dwellSumNs.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+private:
+    std::atomic<uint64_t> m_pushes{0};
+    std::atomic<uint64_t> m_pops{0};
+    std::atomic<uint64_t> m_fullBlocks{0};
+    std::atomic<uint64_t> m_emptyBlocks{0};
+    std::atomic<uint64_t> m_fullWaitNs{0};
+    std::atomic<uint64_t> m_emptyWaitNs{0};
+    std::atomic<uint64_t> m_highWaterMark{0};
+    std::atomic<uint64_t> m_drops{0};
+    std::atomic<uint64_t> m_evictions{0};
+    std::array<std::atomic<uint64_t>, Constants::queueDwellBuckets> m_dwellHistogramNs{};
+    std::atomic<uint64_t> m_dwellSumNs{0};
+};
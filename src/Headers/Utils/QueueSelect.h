@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Utils/EventCount.h"
+#include "Utils/Trace.h"
+
+#include <cstddef>
+#include <optional>
+#include <tuple>
+#include <utility>
+
+// Lets one thread block on several CQueues (any backend, any mix) instead of polling each with
+// TryPopValue or dedicating a thread per queue. The queues share one CEventCount: every push and
+// Close() signals it, which costs a single RMW while nobody is parked, and WaitAny() parks on it
+// until one of them is non-empty.
+//     CQueueSelect select(control, marketData, orders);
+//     while (std::optional<size_t> ready = select.WaitAny())
+//     {
+//         switch (*ready) { case 0: control.TryPopValue(cmd); break; ... }
+//     }
+// Ready queues are reported round robin, so a busy queue does not starve the others. With several
+// consumers on a queue the element may be gone by the time the caller pops; TryPopValue and retry.
+template<typename... Queues>
+class CQueueSelect
+{
+    static_assert(sizeof...(Queues) > 0, "CQueueSelect needs at least one queue");
+
+public:
+    // Attaches the queues to this selector's notifier. Construct before producers start pushing.
+    explicit CQueueSelect(Queues&... queues)
+        : m_queues(queues...)
+    {
+        std::apply([this](auto&... queue) { (queue.SetNotifier(&m_notifier), ...); }, m_queues);
+    }
+
+    // Detaching waits for producers still signalling m_notifier, so the selector may go while the
+    // queues stay in use.
+    ~CQueueSelect()
+    {
+        std::apply([](auto&... queue) { (queue.SetNotifier(nullptr), ...); }, m_queues);
+    }
+
+    CQueueSelect(const CQueueSelect&) = delete;
+    CQueueSelect& operator=(const CQueueSelect&) = delete;
+    CQueueSelect(CQueueSelect&&) = delete;
+    CQueueSelect& operator=(CQueueSelect&&) = delete;
+
+    // Blocks until a queue has an element and returns its index in constructor order. Returns
+    // nullopt once every queue is closed and drained.
+    [[nodiscard]] std::optional<size_t> WaitAny()
+    {
+        std::optional<size_t> ready = TryAny();
+        if (ready || Drained())
+        {
+            return ready;
+        }
+        TWIZ_TRACE_SCOPE("CQueueSelect::WaitAny");
+        m_notifier.WaitUntil(
+            [&]
+            {
+                ready = TryAny();
+                return ready || Drained();
+            });
+        return ready;
+    }
+
+    // Index of a non-empty queue, or nullopt. Never blocks.
+    [[nodiscard]] std::optional<size_t> TryAny()
+    {
+        for (size_t i = 0; i < QueueCount(); ++i)
+        {
+            size_t const index = (m_next + i) % QueueCount();
+            if (HasItems(index, std::index_sequence_for<Queues...>{}))
+            {
+                m_next = (index + 1) % QueueCount();
+                return index;
+            }
+        }
+        return std::nullopt;
+    }
+
+    // True once every queue is closed and empty.
+    [[nodiscard]] bool Drained() const
+    {
+        // Closed() first: it holds only once no push can still land, so an Empty() read afterwards is final.
+        return std::apply([](const auto&... queue) { return ((queue.Closed() && queue.Empty()) && ...); }, m_queues);
+    }
+
+    [[nodiscard]] static constexpr size_t QueueCount() noexcept { return sizeof...(Queues); }
+
+private:
+    template<size_t... I>
+    [[nodiscard]] bool HasItems(size_t index, std::index_sequence<I...> /*indices*/) const
+    {
+        return ((index == I && !std::get<I>(m_queues).Empty()) || ...);
+    }
+
+    std::tuple<Queues&...> m_queues;
+    CEventCount m_notifier;
+    size_t m_next{0};
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Constants.h"
+#include "Utils/WaitPolicy.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+// Single-writer sequence lock. The writer never blocks; readers retry until they copy a version no
+// write overlapped, so Load() never returns a torn value. T must be trivially copyable.
+// The payload is held as atomic words, with release stores and acquire loads ordering it against
+// the sequence counter, so no fences are needed and the race is well defined.
+template<typename T>
+class alignas(Constants::cacheLineSize) CSeqLock
+{
+    static_assert(std::is_trivially_copyable_v<T>, "CSeqLock copies T word by word");
+
+public:
+    CSeqLock() = default;
+    explicit CSeqLock(const T& value) { Store(value); }
+
+    CSeqLock(const CSeqLock&) = delete;
+    CSeqLock& operator=(const CSeqLock&) = delete;
+    CSeqLock(CSeqLock&&) = delete;
+    CSeqLock& operator=(CSeqLock&&) = delete;
+
+    // Writer thread only.
+    void Store(const T& value) noexcept
+    {
+        Words words{};
+        std::memcpy(words.data(), &value, sizeof(T));
+        uint64_t const sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        for (size_t i = 0; i < wordCount; ++i)
+        {
+            m_words[i].store(words[i], std::memory_order_release);
+        }
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Any thread.
+    [[nodiscard]] T Load() const noexcept
+    {
+        Words words{};
+        while (true)
+        {
+            uint64_t const sequence = m_sequence.load(std::memory_order_acquire);
+            if ((sequence & 1) != 0)
+            {
+                Utils::CpuRelax();
+                continue;
+            }
+            for (size_t i = 0; i < wordCount; ++i)
+            {
+                words[i] = m_words[i].load(std::memory_order_acquire);
+            }
+            if (m_sequence.load(std::memory_order_relaxed) == sequence)
+            {
+                break;
+            }
+        }
+        alignas(T) std::byte storage[sizeof(T)];
+        std::memcpy(storage, words.data(), sizeof(T));
+        return *std::launder(reinterpret_cast<T*>(storage));
+    }
+
+    // Number of completed Store() calls.
+    [[nodiscard]] uint64_t Version() const noexcept { return m_sequence.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr size_t wordCount = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    using Words = std::array<uint64_t, wordCount>;
+
+    std::atomic<uint64_t> m_sequence{0};
+    std::array<std::atomic<uint64_t>, wordCount> m_words{};
+};
@@ -0,0 +1,333 @@
+#pragma once
+
+#include "Constants.h"
+#include "Utils/EventCount.h"
+#include "Utils/Queue.h"
+#include "Utils/QueueMetrics.h"
+#include "Utils/Trace.h"
+#include "Utils/WaitPolicy.h"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+
+// Backend tag for a lock-free single-producer/single-consumer ring: CQueue<T, SpscRing[, WaitPolicy[, Metrics]]>
+struct SpscRing
+{
+};
+
+template<typename T, typename WaitPolicy, typename Metrics>
+class CQueue<T, SpscRing, WaitPolicy, Metrics>
+{
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+    CQueue()
+        : CQueue(Constants::maxQueueSize)
+    {
+    }
+    explicit CQueue(size_t capacity)
+        : m_mask(std::bit_ceil(capacity ? capacity : 1) - 1)
+        , m_slots(std::make_unique<Slot[]>(m_mask + 1))
+    {
+    }
+
+    CQueue(const CQueue&) = delete;
+    CQueue& operator=(const CQueue&) = delete;
+    CQueue(CQueue&&) = delete;
+    CQueue& operator=(CQueue&&) = delete;
+
+    ~CQueue()
+    {
+        while (Dequeue())
+        {
+        }
+    }
+
+    void Close()
+    {
+        m_closed.store(true, std::memory_order_seq_cst);
+        m_notEmpty.NotifyAll();
+        m_notFull.NotifyAll();
+        NotifyListener();
+    }
+
+    // Also signals notifier on every push and on Close(), so one consumer can wait on several queues
+    // (CQueueSelect, Utils/QueueSelect.h). Set before producers start. Replacing or detaching (nullptr)
+    // waits for producers still signalling the previous notifier, which may be destroyed once this
+    // returns.
+    void SetNotifier(CEventCount* notifier) noexcept
+    {
+        m_notifier.store(notifier, std::memory_order_seq_cst);
+        while (m_notifying.load(std::memory_order_seq_cst) != 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // BLOCK or DROP_NEWEST only: the other policies discard queued elements, which only the consumer
+    // may touch. Returns false (and changes nothing) for those.
+    bool SetOverflowPolicy(OverflowPolicy policy, size_t /*sampleEvery*/ = 1) noexcept
+    {
+        if (policy != OverflowPolicy::BLOCK && policy != OverflowPolicy::DROP_NEWEST)
+        {
+            return false;
+        }
+        m_overflow.store(policy, std::memory_order_release);
+        m_notFull.NotifyAll();
+        return true;
+    }
+
+    bool Push(const T& value) { return Emplace(value); }
+    bool Push(T&& value) { return Emplace(std::move(value)); }
+
+    bool TryPush(const T& value) { return TryEmplace(value); }
+    bool TryPush(T&& value) { return TryEmplace(std::move(value)); }
+
+    template<typename... Args>
+    bool Emplace(Args&&... args)
+    {
+        while (true)
+        {
+            if (!BeginPush())
+            {
+                return false;
+            }
+            bool const pushed = Enqueue(std::forward<Args>(args)...);
+            EndPush();
+            if (pushed)
+            {
+                m_notEmpty.NotifyOne();
+                NotifyListener();
+                return true;
+            }
+            if (m_overflow.load(std::memory_order_acquire) == OverflowPolicy::DROP_NEWEST)
+            {
+                m_metrics.OnDrop();
+                return true;
+            }
+            WaitNotFull([&] { return m_closed.load(std::memory_order_acquire) || !Full() || m_overflow.load(std::memory_order_acquire) != OverflowPolicy::BLOCK; });
+        }
+    }
+
+    void Pop()
+    {
+        WaitForItem();
+        if (Dequeue())
+        {
+            m_notFull.NotifyOne();
+        }
+    }
+
+    bool PopValue(T& out)
+    {
+        WaitForItem();
+        return TryPopValue(out);
+    }
+
+    bool TryPopValue(T& out)
+    {
+        if (!Dequeue(&out))
+        {
+            return false;
+        }
+        m_notFull.NotifyOne();
+        return true;
+    }
+
+    [[nodiscard]] bool Empty() const noexcept { return Size() == 0; }
+
+    // Exact when called from the producer or consumer thread, a snapshot otherwise.
+    [[nodiscard]] size_type Size() const noexcept
+    {
+        size_t const head = m_head.load(std::memory_order_acquire);
+        size_t const tail = m_tail.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    [[nodiscard]] size_type Capacity() const noexcept { return m_mask + 1; }
+
+    // Closed, and every push that passed the closed check before Close() is in the ring, so an Empty()
+    // read afterwards is final.
+    [[nodiscard]] bool Closed() const noexcept { return m_closed.load(std::memory_order_seq_cst) && m_pushing.load(std::memory_order_seq_cst) == 0; }
+
+    // Lock-free; Snapshot() is all zeros unless Metrics is CQueueMetrics.
+    [[nodiscard]] const Metrics& GetMetrics() const noexcept { return m_metrics; }
+
+private:
+    struct Slot
+    {
+        alignas(T) std::byte m_storage[sizeof(T)];
+        [[no_unique_address]] typename Metrics::Stamp m_stamp;
+    };
+
+    [[nodiscard]] bool Full() const noexcept { return m_tail.load(std::memory_order_relaxed) - m_head.load(std::memory_order_acquire) > m_mask; }
+
+    // Producer side only.
+    template<typename... Args>
+    bool TryEmplace(Args&&... args)
+    {
+        if (!BeginPush())
+        {
+            return false;
+        }
+        bool const pushed = Enqueue(std::forward<Args>(args)...);
+        EndPush();
+        if (!pushed)
+        {
+            return false;
+        }
+        m_notEmpty.NotifyOne();
+        NotifyListener();
+        return true;
+    }
+
+    template<typename... Args>
+    bool Enqueue(Args&&... args)
+    {
+        size_t const tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead > m_mask)
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead > m_mask)
+            {
+                return false;
+            }
+        }
+        Slot& slot = m_slots[tail & m_mask];
+        ::new (static_cast<void*>(slot.m_storage)) T(std::forward<Args>(args)...);
+        slot.m_stamp = Metrics::Now();
+        m_tail.store(tail + 1, std::memory_order_release);
+        if constexpr (Metrics::enabled)
+        {
+            m_metrics.OnPush(tail + 1 - m_head.load(std::memory_order_relaxed));
+        }
+        return true;
+    }
+
+    // Consumer side only. Moves the front element into *out, or discards it when out is null.
+    bool Dequeue(T* out = nullptr)
+    {
+        size_t const head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail)
+            {
+                return false;
+            }
+        }
+        Slot& slot = m_slots[head & m_mask];
+        T* item = std::launder(reinterpret_cast<T*>(slot.m_storage));
+        if (out)
+        {
+            *out = std::move(*item);
+        }
+        item->~T();
+        m_metrics.OnPop(slot.m_stamp);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Counted in m_pushing from the closed check until the element is in the ring. Store-load pairing
+    // with Closed(): either the load here sees m_closed, or Closed() sees the count and reports the
+    // queue open until EndPush().
+    bool BeginPush() noexcept
+    {
+        m_pushing.fetch_add(1, std::memory_order_seq_cst);
+        if (!m_closed.load(std::memory_order_seq_cst))
+        {
+            return true;
+        }
+        EndPush();
+        return false;
+    }
+
+    void EndPush() noexcept
+    {
+        m_pushing.fetch_sub(1, std::memory_order_seq_cst);
+        if (m_closed.load(std::memory_order_seq_cst))
+        {
+            // A consumer may have found the queue closed but this push still counted; it looks again.
+            m_notEmpty.NotifyAll();
+            NotifyListener();
+        }
+    }
+
+    // Counted in m_notifying while the notifier is in use, so SetNotifier() can wait it out. Store-load
+    // pairing with SetNotifier: either the load here sees the new notifier or SetNotifier sees the count.
+    void NotifyListener() noexcept
+    {
+        if (m_notifier.load(std::memory_order_relaxed) == nullptr)
+        {
+            return;
+        }
+        m_notifying.fetch_add(1, std::memory_order_seq_cst);
+        if (CEventCount* notifier = m_notifier.load(std::memory_order_seq_cst))
+        {
+            notifier->NotifyAll();
+        }
+        m_notifying.fetch_sub(1, std::memory_order_release);
+    }
+
+    template<typename Ready>
+    void WaitNotFull(Ready ready)
+    {
+        if (ready())
+        {
+            return;
+        }
+        TWIZ_TRACE_SCOPE("CQueue::WaitNotFull");
+        auto const start = Metrics::Now();
+        WaitPolicy::Wait(m_notFull, ready);
+        m_metrics.OnFullWait(start);
+    }
+
+    template<typename Ready>
+    void WaitNotEmpty(Ready ready)
+    {
+        if (ready())
+        {
+            return;
+        }
+        TWIZ_TRACE_SCOPE("CQueue::WaitNotEmpty");
+        auto const start = Metrics::Now();
+        WaitPolicy::Wait(m_notEmpty, ready);
+        m_metrics.OnEmptyWait(start);
+    }
+
+    // Returns once an element is available or the queue is closed.
+    void WaitForItem()
+    {
+        WaitNotEmpty([&] { return !Empty() || Closed(); });
+    }
+
+    // Consumer-owned line.
+    alignas(Constants::cacheLineSize) std::atomic<size_t> m_head{0};
+    size_t m_cachedTail{0};
+
+    // Producer-owned line.
+    alignas(Constants::cacheLineSize) std::atomic<size_t> m_tail{0};
+    size_t m_cachedHead{0};
+    std::atomic<uint32_t> m_pushing{0}; // pushes between the closed check and the ring
+
+    // Read-mostly shared state.
+    alignas(Constants::cacheLineSize) const size_t m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+    std::atomic<bool> m_closed{false};
+    std::atomic<CEventCount*> m_notifier{nullptr};
+    std::atomic<uint32_t> m_notifying{0}; // producers inside NotifyListener()
+    std::atomic<OverflowPolicy> m_overflow{OverflowPolicy::BLOCK};
+
+    alignas(Constants::cacheLineSize) CEventCount m_notEmpty;
+    alignas(Constants::cacheLineSize) CEventCount m_notFull;
+    [[no_unique_address]] Metrics m_metrics;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Constants.h"
+
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Utils
+{
+
+    // -- Thread Placement --
+    // Operate on the calling thread. Each returns false when the OS rejects the request (for example
+    // SCHED_FIFO without CAP_SYS_NICE or a nonzero priority with OTHER) or the platform does not
+    // support it.
+
+    enum class SchedulingPolicy : std::uint8_t
+    {
+        OTHER = 0,
+        FIFO = 1,
+        RR = 2
+    };
+
+    using CpuMask = std::bitset<Constants::maxTrackedCpus>;
+
+    struct ThreadPlacement
+    {
+        int m_cpu{-1};
+        CpuMask m_allowedCpus;
+        SchedulingPolicy m_policy{SchedulingPolicy::OTHER};
+        int m_priority{0};
+    };
+
+    bool SetCurrentThreadName(const std::string& name);
+    bool SetCurrentThreadAffinity(const std::vector<int>& cpus);
+    bool SetCurrentThreadScheduling(SchedulingPolicy policy, int priority);
+    ThreadPlacement GetCurrentThreadPlacement();
+    int GetCurrentCpu();
+
+    // Process-wide set of CPUs kept for pinned threads. Threads without an explicit affinity are
+    // placed on the process's CPUs (its affinity at startup) minus this set when they start;
+    // already-running threads are not moved. Reservations are counted per CPU: a CPU stays reserved
+    // until every ReserveCpus() naming it has been matched by a ReleaseCpus().
+    void ReserveCpus(const std::vector<int>& cpus);
+    void ReleaseCpus(const std::vector<int>& cpus);
+    std::vector<int> GetUnreservedCpus();
+
+} // namespace Utils
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Constants.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <vector>
+
+struct TimerFireStats
+{
+    uint64_t m_fired{};
+    uint64_t m_missed{};
+    uint64_t m_totalLatenessNs{};
+    uint64_t m_maxLatenessNs{};
+};
+
+// Hierarchical timing wheel (Varghese & Lauck): four levels of 64 slots, so scheduling and cancelling
+// are O(1) and Advance() only visits ticks that hold timers. Deadlines are absolute nanoseconds on
+// the caller's clock and fire at most one resolution late. Single-threaded; callbacks run inside
+// Advance() and may schedule or cancel timers, including their own.
+class CTimerWheel
+{
+public:
+    using TimerId = uint64_t;
+    using Callback = std::function<void()>;
+
+    explicit CTimerWheel(uint64_t nowNs, uint64_t resolutionNs = Constants::timerWheelResolutionUs * 1000);
+
+    CTimerWheel(const CTimerWheel&) = delete;
+    CTimerWheel& operator=(const CTimerWheel&) = delete;
+    CTimerWheel(CTimerWheel&&) = delete;
+    CTimerWheel& operator=(CTimerWheel&&) = delete;
+
+    TimerId ScheduleAt(uint64_t deadlineNs, Callback callback);
+    // Fires at firstDeadlineNs + k * periodNs. A timer that falls whole periods behind skips them
+    // (each counts as missed) instead of firing in a burst.
+    TimerId ScheduleEvery(uint64_t firstDeadlineNs, uint64_t periodNs, Callback callback);
+    bool Cancel(TimerId id);
+
+    // Fires every timer due at nowNs. Lateness beyond Constants::timerSlackUs counts as missed.
+    TimerFireStats Advance(uint64_t nowNs);
+
+    // Earliest time Advance() may have work; never later than the next deadline.
+    [[nodiscard]] std::optional<uint64_t> NextDeadline() const;
+    [[nodiscard]] size_t Size() const noexcept { return m_active; }
+
+private:
+    static constexpr size_t slotBits = 6;
+    static constexpr size_t slotCount = size_t{1} << slotBits;
+    static constexpr size_t levelCount = 4;
+    static constexpr uint64_t noTick = ~uint64_t{0};
+
+    struct Timer
+    {
+        uint64_t m_deadlineNs{};
+        uint64_t m_periodNs{};
+        Callback m_callback;
+        uint32_t m_generation{1};
+        bool m_active{false};
+    };
+
+    // Slots hold (index, generation) so cancelled or recycled timers are skipped lazily.
+    struct Entry
+    {
+        uint32_t m_index;
+        uint32_t m_generation;
+    };
+
+    TimerId Add(uint64_t deadlineNs, uint64_t periodNs, Callback callback);
+    void Insert(Entry entry);
+    void Release(uint32_t index);
+    void Process(uint64_t tick);
+    void FireDue(uint64_t nowNs, TimerFireStats& stats);
+    void Fire(Entry entry, uint64_t nowNs, TimerFireStats& stats);
+    [[nodiscard]] uint64_t NextEventTick() const;
+
+    uint64_t m_resolutionNs;
+    uint64_t m_current;
+    std::array<std::array<std::vector<Entry>, slotCount>, levelCount> m_wheel{};
+    std::array<uint64_t, levelCount> m_occupied{};
+    std::vector<Entry> m_due;
+    std::vector<Entry> m_overflow;
+    std::deque<Timer> m_timers; // stable addresses while a callback runs
+    std::vector<uint32_t> m_free;
+    size_t m_active{0};
+    uint32_t m_firing{~uint32_t{0}};
+};
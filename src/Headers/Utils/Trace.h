@@ -0,0 +1,160 @@
+#pragma once
+
+#include "Constants.h"
+#include "Utils/Clock.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+// Timeline tracing. Threads record spans and instant events into their own lock-free ring; a
+// background flusher drains the rings into a Chrome trace-event JSON file (chrome://tracing, Perfetto UI).
+//     CTracer::Start("trace.json");
+//     { TWIZ_TRACE_SCOPE("Decode"); ... }
+//     TWIZ_TRACE_INSTANT("Reconnect");
+//     CTracer::Stop();
+// Names must be string literals (or otherwise outlive the trace). While tracing is off a tracepoint
+// is one relaxed load and a branch, plus a test of the unengaged scope on exit; define
+// TWIZ_TRACE_DISABLED to compile them out entirely.
+
+struct TraceEvent
+{
+    const char* m_name;
+    uint64_t m_startNs;
+    uint64_t m_durationNs;
+    char m_phase; // 'X' complete span, 'i' instant
+};
+
+// Single-producer ring written by its owning thread and drained only by the flusher. When the
+// flusher falls behind, new events are dropped and counted rather than blocking the thread.
+class CTraceBuffer
+{
+public:
+    CTraceBuffer(uint32_t threadId, std::string threadName, size_t capacity = Constants::traceBufferEvents);
+
+    CTraceBuffer(const CTraceBuffer&) = delete;
+    CTraceBuffer& operator=(const CTraceBuffer&) = delete;
+    CTraceBuffer(CTraceBuffer&&) = delete;
+    CTraceBuffer& operator=(CTraceBuffer&&) = delete;
+
+    // Owning thread only.
+    bool TryPush(const TraceEvent& event) noexcept
+    {
+        size_t const tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead > m_mask)
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead > m_mask)
+            {
+                m_dropped.store(m_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        m_events[tail & m_mask] = event;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Flusher only.
+    template<typename Fn>
+    size_t Drain(Fn&& fn)
+    {
+        size_t const head = m_head.load(std::memory_order_relaxed);
+        size_t const tail = m_tail.load(std::memory_order_acquire);
+        for (size_t i = head; i != tail; ++i)
+        {
+            fn(m_events[i & m_mask]);
+        }
+        m_head.store(tail, std::memory_order_release);
+        return tail - head;
+    }
+
+    void MarkFinished() noexcept { m_finished.store(true, std::memory_order_release); }
+    [[nodiscard]] bool IsFinished() const noexcept { return m_finished.load(std::memory_order_acquire); }
+    [[nodiscard]] uint64_t Dropped() const noexcept { return m_dropped.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint32_t ThreadId() const noexcept { return m_threadId; }
+    [[nodiscard]] const std::string& ThreadName() const noexcept { return m_threadName; }
+
+private:
+    alignas(Constants::cacheLineSize) std::atomic<size_t> m_head{0};
+
+    alignas(Constants::cacheLineSize) std::atomic<size_t> m_tail{0};
+    size_t m_cachedHead{0};
+    std::atomic<uint64_t> m_dropped{0};
+
+    alignas(Constants::cacheLineSize) const size_t m_mask;
+    std::unique_ptr<TraceEvent[]> m_events;
+    std::atomic<bool> m_finished{false};
+    const uint32_t m_threadId;
+    const std::string m_threadName;
+};
+
+class CTracer
+{
+public:
+    [[nodiscard]] static bool IsEnabled() noexcept { return s_enabled.load(std::memory_order_relaxed); }
+
+    // Creates the output file and starts recording and the flusher. False if already running or the
+    // file cannot be opened.
+    static bool Start(const std::string& path);
+    // Stops recording, flushes every buffer and closes the file. Idempotent.
+    static void Stop();
+
+    static void Complete(const char* name, uint64_t startNs, uint64_t endNs) noexcept;
+    static void Instant(const char* name) noexcept;
+
+    // Events lost to full buffers since the process started.
+    [[nodiscard]] static uint64_t Dropped();
+
+private:
+    static CTraceBuffer* LocalBuffer();
+
+    static inline std::atomic<bool> s_enabled{false};
+};
+
+// Records one span, unconditionally; TWIZ_TRACE_SCOPE creates it only while tracing is on.
+class CTraceScope
+{
+public:
+    explicit CTraceScope(const char* name) noexcept
+        : m_name(name)
+        , m_startNs(Utils::GetTickCountNanos())
+    {
+    }
+
+    ~CTraceScope() { CTracer::Complete(m_name, m_startNs, Utils::GetTickCountNanos()); }
+
+    CTraceScope(const CTraceScope&) = delete;
+    CTraceScope& operator=(const CTraceScope&) = delete;
+    CTraceScope(CTraceScope&&) = delete;
+    CTraceScope& operator=(CTraceScope&&) = delete;
+
+private:
+    const char* m_name;
+    uint64_t m_startNs;
+};
+
+#define TWIZ_TRACE_CONCAT_INNER(a, b) a##b
+#define TWIZ_TRACE_CONCAT(a, b) TWIZ_TRACE_CONCAT_INNER(a, b)
+
+#ifdef TWIZ_TRACE_DISABLED
+#define TWIZ_TRACE_SCOPE(name) ((void)0)
+#define TWIZ_TRACE_INSTANT(name) ((void)0)
+#else
+// Expands to a declaration and an if statement; the caller's semicolon ends the if.
+#define TWIZ_TRACE_SCOPE(name)                                              \
+    std::optional<CTraceScope> TWIZ_TRACE_CONCAT(twizTraceScope, __LINE__); \
+    if (CTracer::IsEnabled()) [[unlikely]]                                  \
+        TWIZ_TRACE_CONCAT(twizTraceScope, __LINE__).emplace(name)
+#define TWIZ_TRACE_INSTANT(name)               \
+    do                                         \
+    {                                          \
+        if (CTracer::IsEnabled()) [[unlikely]] \
+        {                                      \
+            CTracer::Instant(name);            \
+        }                                      \
+    } while (0)
+#endif
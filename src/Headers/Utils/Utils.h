@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Utils/Clock.h"
+
 #include <chrono>
 #include <cstdint>
 #include <string>
@@ -11,7 +13,7 @@ namespace Utils
     // -- Time Utilities --
 
     std::chrono::milliseconds GetCurrentTimeMillis();
-    uint64_t GetTickCountMillis();
+    uint64_t GetTickCountMillis(); // GetTickCountNanos() (Utils/Clock.h) in milliseconds
     std::string FormatDurationFromMillis(uint64_t milliseconds);
     std::string MillisToISO8601UTC(uint64_t millisFromEpoch);
 
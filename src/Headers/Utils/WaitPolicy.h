@@ -0,0 +1,159 @@
+#pragma once
+
+#include "Constants.h"
+#include "Utils/EventCount.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Wait strategies for CQueue's WaitPolicy parameter. Each policy provides two overloads:
+//   Wait(lock, cv, ready)  for the mutex-based backend, called with the lock held
+//   Wait(event, ready)     for the lock-free backends
+// and returns once ready() holds. Spinning trades CPU for wakeup latency; parking frees the core.
+// Timed waits (PopBulkFor) always park.
+
+namespace Utils
+{
+    inline void CpuRelax() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(_M_X64) || defined(_M_IX86)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        asm volatile("yield");
+#endif
+    }
+
+    template<typename Ready>
+    bool SpinUntil(Ready& ready, int iterations)
+    {
+        for (int i = 0; i < iterations; ++i)
+        {
+            if (ready())
+            {
+                return true;
+            }
+            CpuRelax();
+        }
+        return ready();
+    }
+
+    // The predicate reads lock-protected state, so the lock is dropped while relaxing.
+    template<typename Ready>
+    bool SpinUntil(std::unique_lock<std::mutex>& lock, Ready& ready, int iterations)
+    {
+        for (int i = 0; i < iterations; ++i)
+        {
+            if (ready())
+            {
+                return true;
+            }
+            lock.unlock();
+            CpuRelax();
+            lock.lock();
+        }
+        return ready();
+    }
+} // namespace Utils
+
+// Parks immediately. Lowest CPU cost, a futex wake on the critical path.
+struct ParkWait
+{
+    template<typename Ready>
+    static void Wait(std::unique_lock<std::mutex>& lock, std::condition_variable& cv, Ready ready)
+    {
+        cv.wait(lock, ready);
+    }
+
+    template<typename Ready>
+    static void Wait(CEventCount& event, Ready ready)
+    {
+        event.WaitUntil(ready);
+    }
+};
+
+// Spins with a pause instruction for Spins rounds, then parks.
+template<int Spins = Constants::waitSpinIterations>
+struct SpinParkWait
+{
+    template<typename Ready>
+    static void Wait(std::unique_lock<std::mutex>& lock, std::condition_variable& cv, Ready ready)
+    {
+        if (!Utils::SpinUntil(lock, ready, Spins))
+        {
+            cv.wait(lock, ready);
+        }
+    }
+
+    template<typename Ready>
+    static void Wait(CEventCount& event, Ready ready)
+    {
+        if (!Utils::SpinUntil(ready, Spins))
+        {
+            event.WaitUntil(ready);
+        }
+    }
+};
+
+// Spins with a pause instruction for Spins rounds, then yields the core between checks. Never parks.
+template<int Spins = Constants::waitSpinIterations>
+struct SpinYieldWait
+{
+    template<typename Ready>
+    static void Wait(std::unique_lock<std::mutex>& lock, std::condition_variable& /*cv*/, Ready ready)
+    {
+        if (Utils::SpinUntil(lock, ready, Spins))
+        {
+            return;
+        }
+        while (!ready())
+        {
+            lock.unlock();
+            std::this_thread::yield();
+            lock.lock();
+        }
+    }
+
+    template<typename Ready>
+    static void Wait(CEventCount& /*event*/, Ready ready)
+    {
+        if (Utils::SpinUntil(ready, Spins))
+        {
+            return;
+        }
+        while (!ready())
+        {
+            std::this_thread::yield();
+        }
+    }
+};
+
+// Spins with a pause instruction until ready. Lowest latency; burns a full core while waiting.
+struct BusySpinWait
+{
+    template<typename Ready>
+    static void Wait(std::unique_lock<std::mutex>& lock, std::condition_variable& /*cv*/, Ready ready)
+    {
+        while (!ready())
+        {
+            lock.unlock();
+            Utils::CpuRelax();
+            lock.lock();
+        }
+    }
+
+    template<typename Ready>
+    static void Wait(CEventCount& /*event*/, Ready ready)
+    {
+        while (!ready())
+        {
+            Utils::CpuRelax();
+        }
+    }
+};
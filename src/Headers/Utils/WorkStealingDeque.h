@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Constants.h"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+// Bounded Chase-Lev work-stealing deque (Le et al., "Correct and Efficient Work-Stealing for Weak
+// Memory Models"). The owning thread pushes and pops at the bottom; any other thread steals from the top.
+// T must be trivially copyable (typically a pointer). Push fails when full; callers fall back elsewhere.
+template<typename T>
+class CWorkStealingDeque
+{
+    static_assert(std::is_trivially_copyable_v<T>, "CWorkStealingDeque stores T in std::atomic");
+
+public:
+    explicit CWorkStealingDeque(size_t capacity = Constants::executorDequeCapacity)
+        : m_mask(std::bit_ceil(capacity ? capacity : 1) - 1)
+        , m_buffer(std::make_unique<std::atomic<T>[]>(m_mask + 1))
+    {
+    }
+
+    CWorkStealingDeque(const CWorkStealingDeque&) = delete;
+    CWorkStealingDeque& operator=(const CWorkStealingDeque&) = delete;
+    CWorkStealingDeque(CWorkStealingDeque&&) = delete;
+    CWorkStealingDeque& operator=(CWorkStealingDeque&&) = delete;
+
+    // Owner only.
+    bool Push(T item) noexcept
+    {
+        int64_t const bottom = m_bottom.load(std::memory_order_relaxed);
+        int64_t const top = m_top.load(std::memory_order_acquire);
+        if (bottom - top > static_cast<int64_t>(m_mask))
+        {
+            return false;
+        }
+        m_buffer[static_cast<size_t>(bottom) & m_mask].store(item, std::memory_order_relaxed);
+        m_bottom.store(bottom + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Owner only. LIFO end.
+    std::optional<T> Pop() noexcept
+    {
+        int64_t const bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(bottom, std::memory_order_seq_cst);
+        int64_t top = m_top.load(std::memory_order_seq_cst);
+        if (top > bottom)
+        {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        T item = m_buffer[static_cast<size_t>(bottom) & m_mask].load(std::memory_order_relaxed);
+        if (top == bottom)
+        {
+            // Last element: race the thieves for it.
+            bool const won = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            if (!won)
+            {
+                return std::nullopt;
+            }
+        }
+        return item;
+    }
+
+    // Any thread. FIFO end. Returns nullopt when empty or when another thief won the race.
+    std::optional<T> Steal() noexcept
+    {
+        int64_t top = m_top.load(std::memory_order_seq_cst);
+        int64_t const bottom = m_bottom.load(std::memory_order_seq_cst);
+        if (top >= bottom)
+        {
+            return std::nullopt;
+        }
+        T item = m_buffer[static_cast<size_t>(top) & m_mask].load(std::memory_order_relaxed);
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return std::nullopt;
+        }
+        return item;
+    }
+
+    // Snapshot.
+    [[nodiscard]] size_t Size() const noexcept
+    {
+        int64_t const bottom = m_bottom.load(std::memory_order_relaxed);
+        int64_t const top = m_top.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+    }
+
+    [[nodiscard]] bool Empty() const noexcept { return Size() == 0; }
+
+private:
+    alignas(Constants::cacheLineSize) std::atomic<int64_t> m_top{0};
+    alignas(Constants::cacheLineSize) std::atomic<int64_t> m_bottom{0};
+    alignas(Constants::cacheLineSize) const size_t m_mask;
+    std::unique_ptr<std::atomic<T>[]> m_buffer;
+};
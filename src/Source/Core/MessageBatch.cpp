@@ -0,0 +1,51 @@
+#include "Core/MessageBatch.h"
+
+#include <algorithm>
+#include <new>
+
+CMessageBatch::CMessageBatch(size_t initialBytes, std::pmr::memory_resource* upstream)
+    : m_upstream(upstream)
+{
+    ReplaceBlock(std::max<size_t>(initialBytes, sizeof(ArenaMessage)));
+}
+
+// Messages live in the arena and are dropped with it, like Reset().
+CMessageBatch::~CMessageBatch()
+{
+    m_messages.clear();
+    m_arena.reset();
+    m_upstream.deallocate(m_block, m_blockSize, alignof(std::max_align_t));
+}
+
+ArenaMessage& CMessageBatch::Add()
+{
+    void* const storage = m_arena->allocate(sizeof(ArenaMessage), alignof(ArenaMessage));
+    ArenaMessage* const message = ::new (storage) ArenaMessage(Allocator());
+    m_messages.push_back(message);
+    return *message;
+}
+
+void CMessageBatch::Reset()
+{
+    m_messages.clear();
+    // Anything in use upstream beyond the retained block is what this batch overflowed by; the next
+    // block holds it, so a batch of the same shape is served without asking upstream.
+    size_t const overflow = m_upstream.Stats().m_bytesInUse - m_blockSize;
+    m_arena->release();
+    if (overflow > 0)
+    {
+        ReplaceBlock(m_blockSize + overflow);
+    }
+}
+
+void CMessageBatch::ReplaceBlock(size_t bytes)
+{
+    m_arena.reset();
+    if (m_block)
+    {
+        m_upstream.deallocate(m_block, m_blockSize, alignof(std::max_align_t));
+    }
+    m_block = static_cast<std::byte*>(m_upstream.allocate(bytes, alignof(std::max_align_t)));
+    m_blockSize = bytes;
+    m_arena.emplace(m_block, m_blockSize, &m_upstream);
+}
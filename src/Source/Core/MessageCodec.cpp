@@ -0,0 +1,164 @@
+#include "Core/MessageCodec.h"
+
+#include <exception>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/bson/bson.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/msgpack/msgpack.hpp>
+#include <limits>
+#include <string_view>
+
+namespace
+{
+    constexpr uint8_t processedFlag = 0x01;
+
+    void StoreLE(uint8_t* out, uint64_t value, size_t bytes) noexcept
+    {
+        for (size_t i = 0; i < bytes; ++i)
+        {
+            out[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    uint64_t LoadLE(const uint8_t* in, size_t bytes) noexcept
+    {
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; ++i)
+        {
+            value |= static_cast<uint64_t>(in[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    // Text JSON is printed here first; kept per thread so the baseline does not allocate per call.
+    thread_local std::string tlText;
+
+    void EncodePayload(const jsoncons::json& payload, PayloadFormat format, std::vector<uint8_t>& out)
+    {
+        switch (format)
+        {
+        case PayloadFormat::JSON:
+            tlText.clear();
+            payload.dump(tlText);
+            out.insert(out.end(), tlText.begin(), tlText.end());
+            break;
+        case PayloadFormat::CBOR:
+            jsoncons::cbor::encode_cbor(payload, out);
+            break;
+        case PayloadFormat::MSGPACK:
+            jsoncons::msgpack::encode_msgpack(payload, out);
+            break;
+        case PayloadFormat::BSON:
+            jsoncons::bson::encode_bson(payload, out);
+            break;
+        }
+    }
+
+    jsoncons::json DecodePayload(std::span<const uint8_t> bytes, PayloadFormat format)
+    {
+        switch (format)
+        {
+        case PayloadFormat::JSON:
+            return jsoncons::json::parse(std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size()));
+        case PayloadFormat::CBOR:
+            return jsoncons::cbor::decode_cbor<jsoncons::json>(bytes.begin(), bytes.end());
+        case PayloadFormat::MSGPACK:
+            return jsoncons::msgpack::decode_msgpack<jsoncons::json>(bytes.begin(), bytes.end());
+        case PayloadFormat::BSON:
+            return jsoncons::bson::decode_bson<jsoncons::json>(bytes.begin(), bytes.end());
+        }
+        return {};
+    }
+} // namespace
+
+bool CMessageCodec::Encode(const Message& message, std::vector<uint8_t>& out) const
+{
+    size_t const start = out.size();
+    out.resize(start + headerSize);
+    try
+    {
+        EncodePayload(message.m_payload, m_format, out);
+    }
+    catch (const std::exception&)
+    {
+        out.resize(start);
+        return false;
+    }
+    size_t const payloadSize = out.size() - start - headerSize;
+    if (payloadSize > std::numeric_limits<uint32_t>::max())
+    {
+        out.resize(start);
+        return false;
+    }
+
+    MessageHeader header;
+    header.m_timestamp = message.m_timestamp;
+    header.m_id = message.m_id;
+    header.m_isProcessed = message.m_isProcessed;
+    header.m_format = m_format;
+    header.m_payloadSize = static_cast<uint32_t>(payloadSize);
+    WriteHeader(header, out.data() + start);
+    return true;
+}
+
+void CMessageCodec::WriteHeader(const MessageHeader& header, uint8_t* out) noexcept
+{
+    StoreLE(out, header.m_timestamp, 8);
+    StoreLE(out + 8, header.m_id, 8);
+    out[16] = header.m_isProcessed ? processedFlag : 0;
+    out[17] = static_cast<uint8_t>(header.m_format);
+    StoreLE(out + 18, 0, 2);
+    StoreLE(out + 20, header.m_payloadSize, 4);
+}
+
+std::optional<MessageHeader> CMessageCodec::PeekHeader(std::span<const uint8_t> bytes) noexcept
+{
+    if (bytes.size() < headerSize || bytes[17] > static_cast<uint8_t>(PayloadFormat::BSON))
+    {
+        return std::nullopt;
+    }
+    MessageHeader header;
+    header.m_timestamp = LoadLE(bytes.data(), 8);
+    header.m_id = LoadLE(bytes.data() + 8, 8);
+    header.m_isProcessed = (bytes[16] & processedFlag) != 0;
+    header.m_format = static_cast<PayloadFormat>(bytes[17]);
+    header.m_payloadSize = static_cast<uint32_t>(LoadLE(bytes.data() + 20, 4));
+    return header;
+}
+
+size_t CMessageCodec::Decode(std::span<const uint8_t> bytes, Message& out)
+{
+    std::optional<MessageHeader> const header = PeekHeader(bytes);
+    if (!header || bytes.size() - headerSize < header->m_payloadSize)
+    {
+        return 0;
+    }
+    try
+    {
+        out.m_payload = DecodePayload(bytes.subspan(headerSize, header->m_payloadSize), header->m_format);
+    }
+    catch (const std::exception&)
+    {
+        return 0;
+    }
+    out.m_timestamp = header->m_timestamp;
+    out.m_id = header->m_id;
+    out.m_isProcessed = header->m_isProcessed;
+    return headerSize + header->m_payloadSize;
+}
+
+const char* CMessageCodec::FormatName(PayloadFormat format) noexcept
+{
+    switch (format)
+    {
+    case PayloadFormat::JSON:
+        return "json";
+    case PayloadFormat::CBOR:
+        return "cbor";
+    case PayloadFormat::MSGPACK:
+        return "msgpack";
+    case PayloadFormat::BSON:
+        return "bson";
+    }
+    return "unknown";
+}
@@ -0,0 +1,413 @@
+#include "Core/MessageLog.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <system_error>
+
+namespace
+{
+    constexpr char segmentMagic[8] = {'T', 'W', 'I', 'Z', 'L', 'O', 'G', '1'};
+    constexpr uint32_t segmentVersion = 1;
+    constexpr const char* segmentExtension = ".twlog";
+    constexpr size_t recordAlignment = 8;
+    constexpr size_t zeroScanChunk = 4096;
+
+    struct SegmentFile
+    {
+        uint64_t m_firstRecord{};
+        std::filesystem::path m_path;
+    };
+
+    void StoreLE(uint8_t* out, uint64_t value, size_t bytes) noexcept
+    {
+        for (size_t i = 0; i < bytes; ++i)
+        {
+            out[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    uint64_t LoadLE(const uint8_t* in, size_t bytes) noexcept
+    {
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; ++i)
+        {
+            value |= static_cast<uint64_t>(in[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    // FNV-1a; catches torn and partly written records, not tampering.
+    uint32_t Checksum(std::span<const uint8_t> bytes) noexcept
+    {
+        uint32_t hash = 2166136261u;
+        for (uint8_t const byte : bytes)
+        {
+            hash = (hash ^ byte) * 16777619u;
+        }
+        return hash;
+    }
+
+    constexpr size_t AlignRecord(size_t bytes) noexcept
+    {
+        return (bytes + recordAlignment - 1) / recordAlignment * recordAlignment;
+    }
+
+    std::filesystem::path SegmentFileName(const std::filesystem::path& directory, uint64_t firstRecord)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%020" PRIu64 "%s", firstRecord, segmentExtension);
+        return directory / name;
+    }
+
+    // Segment files in record order; other files in the directory are ignored.
+    std::vector<SegmentFile> ListSegments(const std::filesystem::path& directory)
+    {
+        std::vector<SegmentFile> segments;
+        std::error_code error;
+        for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory, error))
+        {
+            const std::filesystem::path& path = entry.path();
+            std::string const stem = path.stem().string();
+            uint64_t firstRecord = 0;
+            auto const [end, parsed] = std::from_chars(stem.data(), stem.data() + stem.size(), firstRecord);
+            if (path.extension() == segmentExtension && parsed == std::errc() && end == stem.data() + stem.size())
+            {
+                segments.push_back({firstRecord, path});
+            }
+        }
+        std::sort(segments.begin(), segments.end(), [](const SegmentFile& a, const SegmentFile& b) { return a.m_firstRecord < b.m_firstRecord; });
+        return segments;
+    }
+
+    void WriteSegmentHeader(uint8_t* out, uint64_t firstRecord) noexcept
+    {
+        std::memcpy(out, segmentMagic, sizeof(segmentMagic));
+        StoreLE(out + 8, segmentVersion, 4);
+        StoreLE(out + 12, 0, 4);
+        StoreLE(out + 16, firstRecord, 8);
+        StoreLE(out + 24, 0, 8);
+    }
+
+    bool IsSegmentHeader(std::span<const uint8_t> segment, uint64_t firstRecord) noexcept
+    {
+        return segment.size() >= CMessageLog::segmentHeaderSize && std::memcmp(segment.data(), segmentMagic, sizeof(segmentMagic)) == 0 &&
+               LoadLE(segment.data() + 8, 4) == segmentVersion && LoadLE(segment.data() + 16, 8) == firstRecord;
+    }
+
+    // Zeroes whatever is not already zero, a page-sized chunk at a time so the untouched (sparse) rest of
+    // a segment is only read. Returns the length of the prefix that held data.
+    size_t ZeroTail(std::span<uint8_t> tail) noexcept
+    {
+        size_t dirtyEnd = 0;
+        for (size_t chunk = 0; chunk < tail.size(); chunk += zeroScanChunk)
+        {
+            size_t const end = std::min(chunk + zeroScanChunk, tail.size());
+            if (std::any_of(tail.begin() + static_cast<std::ptrdiff_t>(chunk), tail.begin() + static_cast<std::ptrdiff_t>(end), [](uint8_t byte) { return byte != 0; }))
+            {
+                std::memset(tail.data() + chunk, 0, end - chunk);
+                dirtyEnd = end;
+            }
+        }
+        return dirtyEnd;
+    }
+} // namespace
+
+CMessageLog::CMessageLog(std::filesystem::path directory, size_t segmentBytes, PayloadFormat format)
+    : m_directory(std::move(directory))
+    , m_segmentBytes(std::max(segmentBytes, segmentHeaderSize))
+    , m_codec(format)
+{
+}
+
+bool CMessageLog::Open()
+{
+    Close();
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    if (error)
+    {
+        return false;
+    }
+    m_recordCount = 0;
+    m_recoveredBytes = 0;
+    std::vector<SegmentFile> const segments = ListSegments(m_directory);
+    m_segmentCount = segments.size();
+    if (segments.empty())
+    {
+        return CreateSegment(0);
+    }
+    return Recover(segments.back().m_path, segments.back().m_firstRecord);
+}
+
+void CMessageLog::Close()
+{
+    if (m_segment.IsOpen())
+    {
+        Flush(false);
+        m_segment.Close();
+    }
+}
+
+bool CMessageLog::Append(const Message& message)
+{
+    if (!m_segment.IsOpen())
+    {
+        return false;
+    }
+    m_scratch.clear();
+    if (!m_codec.Encode(message, m_scratch))
+    {
+        return false;
+    }
+    // Stored as wall time: tick values restart at each boot, so they would not order a log that outlives one.
+    StoreLE(m_scratch.data(), Utils::TickNanosToEpochNanos(message.m_timestamp), 8);
+    size_t const recordSize = AlignRecord(recordPrefixSize + m_scratch.size());
+    if (recordSize > m_segmentBytes - segmentHeaderSize)
+    {
+        return false;
+    }
+    if (recordSize > m_segment.Size() - m_writeOffset && !CreateSegment(m_recordCount))
+    {
+        return false;
+    }
+
+    uint8_t* const out = m_segment.MutableBytes().data() + m_writeOffset;
+    std::memcpy(out + recordPrefixSize, m_scratch.data(), m_scratch.size());
+    StoreLE(out + 4, Checksum(m_scratch), 4);
+    // Length last: until it is in place the record reads as the end of the segment.
+    StoreLE(out, m_scratch.size(), 4);
+    m_writeOffset += recordSize;
+    ++m_recordCount;
+    return true;
+}
+
+bool CMessageLog::Flush(bool wait)
+{
+    return m_segment.IsOpen() && m_segment.Sync(0, m_writeOffset, wait);
+}
+
+bool CMessageLog::CreateSegment(uint64_t firstRecord)
+{
+    Close();
+    std::filesystem::path const path = SegmentFileName(m_directory, firstRecord);
+    if (!m_segment.OpenWritable(path.string(), m_segmentBytes))
+    {
+        return false;
+    }
+    WriteSegmentHeader(m_segment.MutableBytes().data(), firstRecord);
+    m_segmentPath = path;
+    m_writeOffset = segmentHeaderSize;
+    ++m_segmentCount;
+    return true;
+}
+
+// Finds the end of the intact records in the last segment and zeroes what a crash left after it.
+bool CMessageLog::Recover(const std::filesystem::path& path, uint64_t firstRecord)
+{
+    if (!m_segment.OpenWritable(path.string(), segmentHeaderSize))
+    {
+        return false;
+    }
+    std::span<uint8_t> const bytes = m_segment.MutableBytes();
+    if (!IsSegmentHeader(bytes, firstRecord))
+    {
+        // Created but never written: the file name still says where it starts.
+        std::memset(bytes.data(), 0, segmentHeaderSize);
+        WriteSegmentHeader(bytes.data(), firstRecord);
+    }
+    size_t offset = segmentHeaderSize;
+    uint64_t records = 0;
+    while (size_t const length = ScanRecord(bytes, offset))
+    {
+        offset += length;
+        ++records;
+    }
+    m_recoveredBytes = ZeroTail(bytes.subspan(offset));
+    if (m_recoveredBytes > 0)
+    {
+        m_segment.Sync(offset, m_recoveredBytes, true);
+    }
+    m_segmentPath = path;
+    m_writeOffset = offset;
+    m_recordCount = firstRecord + records;
+    return true;
+}
+
+size_t CMessageLog::ScanRecord(std::span<const uint8_t> segment, size_t offset) noexcept
+{
+    if (offset > segment.size() || segment.size() - offset < recordPrefixSize + CMessageCodec::headerSize)
+    {
+        return 0;
+    }
+    size_t const length = LoadLE(segment.data() + offset, 4);
+    size_t const total = AlignRecord(recordPrefixSize + length);
+    if (length < CMessageCodec::headerSize || total > segment.size() - offset)
+    {
+        return 0;
+    }
+    std::span<const uint8_t> const encoded = segment.subspan(offset + recordPrefixSize, length);
+    std::optional<MessageHeader> const header = CMessageCodec::PeekHeader(encoded);
+    if (!header || header->m_payloadSize != length - CMessageCodec::headerSize || Checksum(encoded) != LoadLE(segment.data() + offset + 4, 4))
+    {
+        return 0;
+    }
+    return total;
+}
+
+CMessageLogReader::CMessageLogReader(std::filesystem::path directory)
+    : m_directory(std::move(directory))
+{
+}
+
+bool CMessageLogReader::Open()
+{
+    Close();
+    std::error_code error;
+    if (!std::filesystem::is_directory(m_directory, error))
+    {
+        return false;
+    }
+    uint64_t lastTimestamp = 0;
+    uint64_t lastId = 0;
+    for (const SegmentFile& file : ListSegments(m_directory))
+    {
+        Segment segment;
+        segment.m_file = std::make_unique<CMappedFile>();
+        segment.m_firstRecord = file.m_firstRecord;
+        if (!segment.m_file->Open(file.m_path.string()))
+        {
+            Close();
+            return false;
+        }
+        std::span<const uint8_t> const bytes = segment.m_file->Bytes();
+        size_t offset = CMessageLog::segmentHeaderSize;
+        if (IsSegmentHeader(bytes, file.m_firstRecord))
+        {
+            uint64_t record = file.m_firstRecord;
+            while (size_t const length = CMessageLog::ScanRecord(bytes, offset))
+            {
+                // ScanRecord has checked the header.
+                MessageHeader const header = *CMessageCodec::PeekHeader(bytes.subspan(offset + CMessageLog::recordPrefixSize));
+                m_timestampsOrdered = m_timestampsOrdered && header.m_timestamp >= lastTimestamp;
+                m_idsOrdered = m_idsOrdered && header.m_id >= lastId;
+                lastTimestamp = header.m_timestamp;
+                lastId = header.m_id;
+                if (record % Constants::messageLogIndexInterval == 0)
+                {
+                    m_index.push_back({header.m_timestamp, header.m_id, record, m_segments.size(), offset});
+                }
+                offset += length;
+                ++record;
+            }
+            m_recordCount += record - file.m_firstRecord;
+        }
+        segment.m_end = offset;
+        m_segments.push_back(std::move(segment));
+    }
+    Rewind();
+    return true;
+}
+
+void CMessageLogReader::Close()
+{
+    m_segments.clear();
+    m_index.clear();
+    m_recordCount = 0;
+    m_timestampsOrdered = true;
+    m_idsOrdered = true;
+    Rewind();
+}
+
+bool CMessageLogReader::Next(LogRecord& out)
+{
+    if (!Peek(out))
+    {
+        return false;
+    }
+    Advance(out);
+    return true;
+}
+
+bool CMessageLogReader::SeekTimestamp(uint64_t timestamp)
+{
+    return Seek(timestamp, m_timestampsOrdered, [](const auto& entry) { return entry.m_timestamp; });
+}
+
+bool CMessageLogReader::SeekId(uint64_t id)
+{
+    return Seek(id, m_idsOrdered, [](const auto& entry) { return entry.m_id; });
+}
+
+void CMessageLogReader::Rewind() noexcept
+{
+    m_segment = 0;
+    m_offset = CMessageLog::segmentHeaderSize;
+    m_record = m_segments.empty() ? 0 : m_segments.front().m_firstRecord;
+}
+
+bool CMessageLogReader::Peek(LogRecord& out)
+{
+    while (m_segment < m_segments.size())
+    {
+        const Segment& segment = m_segments[m_segment];
+        if (m_offset < segment.m_end)
+        {
+            // Checked by Open(), so only the length is read here.
+            std::span<const uint8_t> const bytes = segment.m_file->Bytes();
+            size_t const length = LoadLE(bytes.data() + m_offset, 4);
+            out.m_bytes = bytes.subspan(m_offset + CMessageLog::recordPrefixSize, length);
+            out.m_header = *CMessageCodec::PeekHeader(out.m_bytes);
+            out.m_record = m_record;
+            return true;
+        }
+        ++m_segment;
+        m_offset = CMessageLog::segmentHeaderSize;
+        if (m_segment < m_segments.size())
+        {
+            m_record = m_segments[m_segment].m_firstRecord;
+        }
+    }
+    return false;
+}
+
+void CMessageLogReader::Advance(const LogRecord& record) noexcept
+{
+    m_offset += AlignRecord(CMessageLog::recordPrefixSize + record.m_bytes.size());
+    ++m_record;
+}
+
+// Starts from the last index entry below target, then scans; at most one index interval is read. An
+// unordered key (a wall clock stepped back mid-capture) cannot be binary searched, so that scan starts
+// at the front.
+template<typename Key>
+bool CMessageLogReader::Seek(uint64_t target, bool ordered, Key key)
+{
+    auto const after = ordered ? std::lower_bound(m_index.begin(), m_index.end(), target, [&](const LogIndexEntry& entry, uint64_t value) { return key(entry) < value; }) : m_index.begin();
+    if (after == m_index.begin())
+    {
+        Rewind();
+    }
+    else
+    {
+        const LogIndexEntry& entry = *std::prev(after);
+        m_segment = entry.m_segment;
+        m_offset = entry.m_offset;
+        m_record = entry.m_record;
+    }
+    LogRecord record;
+    while (Peek(record))
+    {
+        if (key(record.m_header) >= target)
+        {
+            return true;
+        }
+        Advance(record);
+    }
+    return false;
+}
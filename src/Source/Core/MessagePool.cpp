@@ -0,0 +1,93 @@
+#include "Core/MessagePool.h"
+
+#include <cstddef>
+#include <cstdint>
+
+void CMessagePool::Deleter::operator()(Message* message) const noexcept
+{
+    if (m_pool)
+    {
+        m_pool->Release(message);
+    }
+    else
+    {
+        delete message;
+    }
+}
+
+CMessagePool::CMessagePool(size_t capacity, size_t prefill)
+    : m_free(capacity)
+{
+    for (size_t i = 0; i < prefill && i < m_free.Capacity(); ++i)
+    {
+        m_free.TryPush(new Message{});
+    }
+}
+
+CMessagePool::~CMessagePool()
+{
+    Message* message = nullptr;
+    while (m_free.TryPopValue(message))
+    {
+        delete message;
+    }
+}
+
+CMessagePool::Handle CMessagePool::Acquire()
+{
+    Message* message = nullptr;
+    if (m_free.TryPopValue(message))
+    {
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        message = new Message{};
+    }
+    m_outstanding.fetch_add(1, std::memory_order_relaxed);
+    return Handle(message, Deleter{this});
+}
+
+MessagePoolMetrics CMessagePool::GetMetrics() const noexcept
+{
+    MessagePoolMetrics metrics;
+    metrics.m_hits = m_hits.load(std::memory_order_relaxed);
+    metrics.m_misses = m_misses.load(std::memory_order_relaxed);
+    metrics.m_recycled = m_recycled.load(std::memory_order_relaxed);
+    metrics.m_discarded = m_discarded.load(std::memory_order_relaxed);
+    metrics.m_available = m_free.Size();
+    metrics.m_outstanding = m_outstanding.load(std::memory_order_relaxed);
+    return metrics;
+}
+
+void CMessagePool::Release(Message* message) noexcept
+{
+    m_outstanding.fetch_sub(1, std::memory_order_relaxed);
+    Reset(*message);
+    if (m_free.TryPush(message))
+    {
+        m_recycled.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        m_discarded.fetch_add(1, std::memory_order_relaxed);
+        delete message;
+    }
+}
+
+void CMessagePool::Reset(Message& message) noexcept
+{
+    message.m_timestamp = 0;
+    message.m_id = 0;
+    message.m_isProcessed = false;
+    // clear() drops the members but keeps the object/array buffer; scalars and strings are replaced.
+    if (message.m_payload.is_object() || message.m_payload.is_array())
+    {
+        message.m_payload.clear();
+    }
+    else
+    {
+        message.m_payload = jsoncons::json();
+    }
+}
@@ -0,0 +1,35 @@
+#include "Core/MetricsRegistry.h"
+
+#include <utility>
+
+CMetricsRegistry& CMetricsRegistry::Instance()
+{
+    static CMetricsRegistry registry;
+    return registry;
+}
+
+void CMetricsRegistry::RegisterQueue(const void* owner, std::string name, QueueSnapshotFn snapshot, QueueSizeFn size)
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_queues.push_back({owner, std::move(name), std::move(snapshot), std::move(size)});
+}
+
+void CMetricsRegistry::RegisterPool(const void* owner, std::string name, PoolSnapshotFn snapshot)
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_pools.push_back({owner, std::move(name), std::move(snapshot)});
+}
+
+void CMetricsRegistry::RegisterHistogram(const CLatencyHistogram& histogram, std::string name)
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_histograms.push_back({std::move(name), &histogram});
+}
+
+void CMetricsRegistry::Unregister(const void* owner)
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    std::erase_if(m_queues, [owner](const QueueEntry& entry) { return entry.m_owner == owner; });
+    std::erase_if(m_pools, [owner](const PoolEntry& entry) { return entry.m_owner == owner; });
+    std::erase_if(m_histograms, [owner](const HistogramEntry& entry) { return entry.m_histogram == owner; });
+}
@@ -0,0 +1,231 @@
+#include "Core/MetricsServer.h"
+#include "Core/PrometheusWriter.h"
+#include "Utils/ThreadPlacement.h"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/http.hpp>
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace asio = boost::asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+using tcp = asio::ip::tcp;
+
+namespace
+{
+    using ArenaFields = http::basic_fields<std::pmr::polymorphic_allocator<char>>;
+    using RequestParser = http::request_parser<http::empty_body, std::pmr::polymorphic_allocator<char>>;
+    using Response = http::response<http::span_body<const char>, ArenaFields>;
+    using ResponseSerializer = http::response_serializer<http::span_body<const char>, ArenaFields>;
+
+    constexpr char contentType[] = "text/plain; version=0.0.4; charset=utf-8";
+    constexpr std::string_view notFound = "Not Found\n";
+
+    // One keep-alive connection. The request and response headers live in a per-request arena over a
+    // fixed member buffer; the body string and read buffer keep their capacity across requests.
+    class CSession : public std::enable_shared_from_this<CSession>
+    {
+    public:
+        explicit CSession(tcp::socket socket)
+            : m_stream(std::move(socket))
+        {
+            m_body.reserve(Constants::metricsBodyReserve);
+        }
+
+        void Run() { Read(); }
+
+        void Close()
+        {
+            beast::error_code ec;
+            m_stream.socket().shutdown(tcp::socket::shutdown_both, ec);
+            m_stream.socket().close(ec);
+        }
+
+    private:
+        void Read()
+        {
+            m_serializer.reset();
+            m_response.reset();
+            m_parser.reset();
+            m_arena.release();
+            m_parser.emplace(std::piecewise_construct, std::make_tuple(), std::make_tuple(std::pmr::polymorphic_allocator<char>(&m_arena)));
+            http::async_read(m_stream, m_buffer, *m_parser, [self = shared_from_this()](beast::error_code ec, size_t) { self->OnRead(ec); });
+        }
+
+        void OnRead(beast::error_code ec)
+        {
+            if (ec)
+            {
+                Close();
+                return;
+            }
+            const auto& request = m_parser->get();
+            std::string_view target(request.target().data(), request.target().size());
+            bool const isMetrics = target == "/metrics" || target.starts_with("/metrics?");
+            bool const isRead = request.method() == http::verb::get || request.method() == http::verb::head;
+
+            m_response.emplace(std::piecewise_construct, std::make_tuple(), std::make_tuple(std::pmr::polymorphic_allocator<char>(&m_arena)));
+            Response& response = *m_response;
+            response.version(request.version());
+            response.keep_alive(request.keep_alive());
+            if (isMetrics && isRead)
+            {
+                m_writer.Render(m_body);
+                response.result(http::status::ok);
+                response.set(http::field::content_type, contentType);
+                response.body() = http::span_body<const char>::value_type(m_body.data(), m_body.size());
+            }
+            else
+            {
+                response.result(isMetrics ? http::status::method_not_allowed : http::status::not_found);
+                response.body() = http::span_body<const char>::value_type(notFound.data(), notFound.size());
+            }
+            response.prepare_payload();
+            if (request.method() == http::verb::head)
+            {
+                response.body() = {};
+            }
+            // Serializing through our own serializer keeps async_write from allocating one per response.
+            m_serializer.emplace(response);
+            http::async_write(m_stream, *m_serializer, [self = shared_from_this()](beast::error_code writeEc, size_t) { self->OnWrite(writeEc); });
+        }
+
+        void OnWrite(beast::error_code ec)
+        {
+            if (ec || !m_response->keep_alive())
+            {
+                Close();
+                return;
+            }
+            Read();
+        }
+
+        beast::tcp_stream m_stream;
+        beast::flat_buffer m_buffer;
+        std::array<std::byte, Constants::metricsArenaBytes> m_arenaBytes{};
+        std::pmr::monotonic_buffer_resource m_arena{m_arenaBytes.data(), m_arenaBytes.size()};
+        std::optional<RequestParser> m_parser;
+        std::optional<Response> m_response;
+        std::optional<ResponseSerializer> m_serializer;
+        std::string m_body;
+        CPrometheusWriter m_writer;
+    };
+} // namespace
+
+struct CMetricsServer::State
+{
+    asio::io_context m_io{1};
+    tcp::acceptor m_acceptor{m_io};
+    std::vector<std::weak_ptr<CSession>> m_sessions;
+
+    void Accept()
+    {
+        m_acceptor.async_accept([this](beast::error_code ec, tcp::socket socket) {
+            if (ec)
+            {
+                return;
+            }
+            auto session = std::make_shared<CSession>(std::move(socket));
+            std::erase_if(m_sessions, [](const std::weak_ptr<CSession>& weak) { return weak.expired(); });
+            m_sessions.push_back(session);
+            session->Run();
+            Accept();
+        });
+    }
+
+    void CloseAll()
+    {
+        beast::error_code ec;
+        m_acceptor.close(ec);
+        for (const auto& weak : m_sessions)
+        {
+            if (auto session = weak.lock())
+            {
+                session->Close();
+            }
+        }
+        m_sessions.clear();
+    }
+};
+
+CMetricsServer::CMetricsServer(uint16_t port, std::string address)
+    : m_address(std::move(address))
+    , m_port(port)
+{
+}
+
+CMetricsServer::~CMetricsServer()
+{
+    Stop();
+}
+
+bool CMetricsServer::Start()
+{
+    if (m_isRunning.exchange(true))
+    {
+        return true;
+    }
+    auto state = std::make_unique<State>();
+    beast::error_code ec;
+    tcp::endpoint const endpoint(asio::ip::make_address(m_address, ec), m_port);
+    if (!ec)
+    {
+        state->m_acceptor.open(endpoint.protocol(), ec);
+    }
+    if (!ec)
+    {
+        state->m_acceptor.set_option(asio::socket_base::reuse_address(true), ec);
+    }
+    if (!ec)
+    {
+        state->m_acceptor.bind(endpoint, ec);
+    }
+    if (!ec)
+    {
+        state->m_acceptor.listen(asio::socket_base::max_listen_connections, ec);
+    }
+    if (ec)
+    {
+        std::cerr << "CMetricsServer: cannot listen on " << m_address << ":" << m_port << ": " << ec.message() << "\n";
+        m_isRunning.store(false, std::memory_order_release);
+        return false;
+    }
+    m_boundPort.store(state->m_acceptor.local_endpoint().port(), std::memory_order_release);
+    m_state = std::move(state);
+    m_state->Accept();
+    m_thread = std::thread([this] {
+        Utils::SetCurrentThreadName("twiz-metrics");
+        m_state->m_io.run();
+    });
+    return true;
+}
+
+void CMetricsServer::Stop()
+{
+    if (!m_isRunning.exchange(false))
+    {
+        return;
+    }
+    asio::post(m_state->m_io, [state = m_state.get()] { state->CloseAll(); });
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+    m_state.reset();
+    m_boundPort.store(0, std::memory_order_release);
+}
@@ -0,0 +1,103 @@
+#include "Core/NdjsonIngester.h"
+
+#include <algorithm>
+#include <exception>
+
+CNdjsonIngester::CNdjsonIngester(NdjsonOptions options)
+    : m_options(std::move(options))
+{
+}
+
+bool CNdjsonIngester::ParseLine(std::string_view line, Message& out)
+{
+    if (line.find_first_not_of(" \t\r") == std::string_view::npos)
+    {
+        return false;
+    }
+    ++m_stats.m_lines;
+    try
+    {
+        if (m_cursor)
+        {
+            m_cursor->reset(line);
+        }
+        else
+        {
+            m_cursor.emplace(line);
+        }
+        if (!m_decoder)
+        {
+            m_decoder.emplace();
+        }
+
+        out.m_id = m_sequence;
+        if (m_options.m_fields.empty() && m_options.m_idField.empty())
+        {
+            out.m_payload = ReadValue();
+        }
+        else if (!ParseMembers(out))
+        {
+            ++m_stats.m_malformed;
+            return false;
+        }
+    }
+    catch (const std::exception&)
+    {
+        // The decoder may hold a half-built value; the cursor is reset by the next line anyway.
+        m_decoder.reset();
+        ++m_stats.m_malformed;
+        return false;
+    }
+    ++m_sequence;
+    return true;
+}
+
+// Walks the top-level members of an object line: projected ones are decoded into the payload, the
+// rest are read through a visitor that ignores every event.
+bool CNdjsonIngester::ParseMembers(Message& out)
+{
+    jsoncons::json_string_cursor& cursor = *m_cursor;
+    if (cursor.done() || cursor.current().event_type() != jsoncons::staj_event_type::begin_object)
+    {
+        return false;
+    }
+    out.m_payload = jsoncons::json(jsoncons::json_object_arg);
+    cursor.next();
+    while (!cursor.done() && cursor.current().event_type() == jsoncons::staj_event_type::key)
+    {
+        // The key views the cursor's buffer, so a projected one is copied before moving on.
+        auto const key = cursor.current().get<std::string_view>();
+        bool const projected = IsProjected(key);
+        bool const isId = !m_options.m_idField.empty() && key == m_options.m_idField;
+        std::string name = projected ? std::string(key) : std::string();
+        cursor.next();
+
+        jsoncons::staj_event_type const type = cursor.current().event_type();
+        if (isId && (type == jsoncons::staj_event_type::uint64_value || type == jsoncons::staj_event_type::int64_value))
+        {
+            out.m_id = cursor.current().get<uint64_t>();
+        }
+        if (projected)
+        {
+            out.m_payload.try_emplace(std::move(name), ReadValue());
+        }
+        else
+        {
+            cursor.read_to(m_skip);
+        }
+        cursor.next();
+    }
+    return true;
+}
+
+bool CNdjsonIngester::IsProjected(std::string_view key) const noexcept
+{
+    return m_options.m_fields.empty() || std::find(m_options.m_fields.begin(), m_options.m_fields.end(), key) != m_options.m_fields.end();
+}
+
+// Decodes the value at the cursor, a scalar or a whole subtree, leaving the cursor on its last event.
+jsoncons::json CNdjsonIngester::ReadValue()
+{
+    m_cursor->read_to(*m_decoder);
+    return m_decoder->get_result();
+}
@@ -0,0 +1,160 @@
+#include "Core/Pipeline.h"
+#include "Utils/Utils.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <unordered_map>
+
+CPipeline::~CPipeline()
+{
+    Stop();
+}
+
+bool CPipeline::Start()
+{
+    if (m_started)
+    {
+        return false;
+    }
+    if (!SortStages())
+    {
+        std::cerr << "CPipeline: the stage graph has a cycle\n";
+        return false;
+    }
+    m_started = true;
+    m_lastSnapshots.assign(m_edges.size(), QueueMetricsSnapshot{});
+    m_lastReportNs = Utils::GetTickCountNanos();
+    for (auto it = m_order.rbegin(); it != m_order.rend(); ++it)
+    {
+        (*it)->Start();
+    }
+    return true;
+}
+
+void CPipeline::Close()
+{
+    for (CPipelineStageBase* stage : m_order)
+    {
+        if (stage->m_inputEdges.empty())
+        {
+            stage->Stop();
+        }
+    }
+    Wait();
+}
+
+void CPipeline::Wait()
+{
+    for (CPipelineStageBase* stage : m_order)
+    {
+        stage->Join();
+        stage->Stop();
+    }
+}
+
+void CPipeline::Stop()
+{
+    for (const auto& edge : m_edges)
+    {
+        edge->Close();
+    }
+    for (CPipelineStageBase* stage : m_order)
+    {
+        stage->Stop();
+    }
+}
+
+// Kahn's algorithm; m_order lists producers before their consumers.
+bool CPipeline::SortStages()
+{
+    std::unordered_map<const CPipelineStageBase*, size_t> pending;
+    m_order.clear();
+    for (const auto& stage : m_stages)
+    {
+        pending[stage.get()] = stage->m_inputEdges.size();
+        if (stage->m_inputEdges.empty())
+        {
+            m_order.push_back(stage.get());
+        }
+    }
+    for (size_t i = 0; i < m_order.size(); ++i)
+    {
+        for (const CPipelineEdgeBase* edge : m_order[i]->m_outputEdges)
+        {
+            if (--pending[&edge->To()] == 0)
+            {
+                m_order.push_back(&edge->To());
+            }
+        }
+    }
+    return m_order.size() == m_stages.size();
+}
+
+PipelineReport CPipeline::Report()
+{
+    uint64_t const now = Utils::GetTickCountNanos();
+    uint64_t const intervalNs = now > m_lastReportNs ? now - m_lastReportNs : 1;
+    m_lastReportNs = now;
+    m_lastSnapshots.resize(m_edges.size());
+
+    PipelineReport report;
+    report.m_intervalSeconds = static_cast<double>(intervalNs) / 1e9;
+    report.m_edges.reserve(m_edges.size());
+    double worstBlocked = 0.0;
+    double worstFill = Constants::pipelineSaturatedFill;
+    std::optional<size_t> fullest;
+    for (size_t i = 0; i < m_edges.size(); ++i)
+    {
+        const CPipelineEdgeBase& edge = *m_edges[i];
+        QueueMetricsSnapshot const snapshot = edge.Snapshot();
+        QueueMetricsSnapshot& last = m_lastSnapshots[i];
+
+        PipelineEdgeReport row;
+        row.m_name = edge.Name();
+        row.m_from = edge.From().Name();
+        row.m_to = edge.To().Name();
+        row.m_pushes = snapshot.m_pushes - last.m_pushes;
+        row.m_pops = snapshot.m_pops - last.m_pops;
+        row.m_throughput = static_cast<double>(row.m_pops) / report.m_intervalSeconds;
+        row.m_size = edge.Size();
+        row.m_capacity = edge.Capacity();
+        row.m_fill = row.m_capacity ? static_cast<double>(row.m_size) / static_cast<double>(row.m_capacity) : 0.0;
+        row.m_blockedFraction = static_cast<double>(snapshot.m_fullWaitNs - last.m_fullWaitNs) / static_cast<double>(intervalNs);
+        last = snapshot;
+
+        if (row.m_blockedFraction > worstBlocked)
+        {
+            worstBlocked = row.m_blockedFraction;
+            report.m_saturated = i;
+        }
+        if (row.m_fill >= worstFill)
+        {
+            worstFill = row.m_fill;
+            fullest = i;
+        }
+        report.m_edges.push_back(std::move(row));
+    }
+    if (!report.m_saturated)
+    {
+        report.m_saturated = fullest;
+    }
+    return report;
+}
+
+void PipelineReport::Print(std::ostream& out) const
+{
+    out << "[pipeline over " << std::fixed << std::setprecision(2) << m_intervalSeconds << " s]\n";
+    for (const PipelineEdgeReport& edge : m_edges)
+    {
+        out << "  " << edge.m_name << ": " << static_cast<uint64_t>(edge.m_throughput) << " msg/s, fill " << edge.m_size << "/" << edge.m_capacity << ", producer blocked "
+            << std::setprecision(1) << edge.m_blockedFraction * 100.0 << "%\n";
+    }
+    if (m_saturated)
+    {
+        const PipelineEdgeReport& edge = m_edges[*m_saturated];
+        out << "  saturated at " << edge.m_name << ": " << edge.m_to << " is the bottleneck\n";
+    }
+    out << std::defaultfloat;
+}
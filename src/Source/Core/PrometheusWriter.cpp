@@ -0,0 +1,301 @@
+#include "Core/PrometheusWriter.h"
+#include "Core/MetricsRegistry.h"
+#include "Core/ThreadRegistry.h"
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace
+{
+    template<typename Value>
+    void AppendNumber(std::string& out, Value value)
+    {
+        char digits[32];
+        std::to_chars_result result{};
+        if constexpr (std::is_same_v<Value, bool>)
+        {
+            result = std::to_chars(digits, digits + sizeof(digits), value ? 1 : 0);
+        }
+        else
+        {
+            result = std::to_chars(digits, digits + sizeof(digits), value);
+        }
+        out.append(digits, result.ptr);
+    }
+
+    // label="value" with the exposition format's escapes.
+    void AppendLabel(std::string& out, std::string_view label, std::string_view value)
+    {
+        out.append(label);
+        out += "=\"";
+        for (char const c : value)
+        {
+            if (c == '\\' || c == '"')
+            {
+                out += '\\';
+                out += c;
+            }
+            else if (c == '\n')
+            {
+                out += "\\n";
+            }
+            else
+            {
+                out += c;
+            }
+        }
+        out += '"';
+    }
+
+    void AppendHeader(std::string& out, std::string_view name, std::string_view type, std::string_view help)
+    {
+        out += "# HELP ";
+        out.append(name);
+        out += ' ';
+        out.append(help);
+        out += "\n# TYPE ";
+        out.append(name);
+        out += ' ';
+        out.append(type);
+        out += '\n';
+    }
+
+    template<typename Value>
+    void AppendSample(std::string& out, std::string_view name, std::string_view labels, Value value, std::string_view extraLabel = {})
+    {
+        out.append(name);
+        out += '{';
+        out.append(labels);
+        if (!extraLabel.empty())
+        {
+            out += ',';
+            out.append(extraLabel);
+        }
+        out += "} ";
+        AppendNumber(out, value);
+        out += '\n';
+    }
+
+    struct AllRows
+    {
+        bool operator()(const auto& /*row*/) const { return true; }
+    };
+
+    // One gauge or counter family over the rows in [0, count) that keep() accepts.
+    template<typename Rows, typename Get, typename Keep = AllRows>
+    void AppendFamily(std::string& out, std::string_view name, std::string_view type, std::string_view help, const Rows& rows, size_t count, Get get, Keep keep = {})
+    {
+        bool header = false;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!keep(rows[i]))
+            {
+                continue;
+            }
+            if (!header)
+            {
+                AppendHeader(out, name, type, help);
+                header = true;
+            }
+            AppendSample(out, name, rows[i].m_labels, get(rows[i]));
+        }
+    }
+
+    template<typename Rows, typename Get>
+    void AppendSummaryFamily(std::string& out, std::string_view name, std::string_view sumName, std::string_view countName, std::string_view help, const Rows& rows, size_t count, Get get)
+    {
+        bool any = false;
+        for (size_t i = 0; i < count && !any; ++i)
+        {
+            any = get(rows[i]).m_present;
+        }
+        if (!any)
+        {
+            return;
+        }
+        AppendHeader(out, name, "summary", help);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto& summary = get(rows[i]);
+            if (!summary.m_present)
+            {
+                continue;
+            }
+            std::string_view const labels = rows[i].m_labels;
+            AppendSample(out, name, labels, summary.m_p50, "quantile=\"0.5\"");
+            AppendSample(out, name, labels, summary.m_p90, "quantile=\"0.9\"");
+            AppendSample(out, name, labels, summary.m_p99, "quantile=\"0.99\"");
+            AppendSample(out, name, labels, summary.m_p999, "quantile=\"0.999\"");
+            AppendSample(out, sumName, labels, summary.m_sum);
+            AppendSample(out, countName, labels, summary.m_count);
+        }
+    }
+
+    template<typename Rows>
+    Rows::value_type& NextRow(Rows& rows, size_t& count)
+    {
+        if (count == rows.size())
+        {
+            rows.emplace_back();
+        }
+        return rows[count++];
+    }
+} // namespace
+
+void CPrometheusWriter::Render(std::string& out)
+{
+    Collect();
+    out.clear();
+    WriteThreads(out);
+    WriteQueues(out);
+    WritePools(out);
+    WriteHistograms(out);
+}
+
+void CPrometheusWriter::Collect()
+{
+    auto summarize = [](const CLatencyHistogram* histogram, Summary& summary) {
+        summary.m_present = histogram != nullptr;
+        if (!histogram)
+        {
+            return;
+        }
+        LatencyHistogramSnapshot const snapshot = histogram->Snapshot();
+        summary.m_count = snapshot.m_count;
+        summary.m_sum = snapshot.m_sum;
+        summary.m_p50 = snapshot.Percentile(50.0);
+        summary.m_p90 = snapshot.Percentile(90.0);
+        summary.m_p99 = snapshot.Percentile(99.0);
+        summary.m_p999 = snapshot.Percentile(99.9);
+    };
+
+    m_threadCount = 0;
+    CThreadRegistry::Instance().ForEachThread(
+        [&](const std::string& uuid, const std::string& name, const ThreadMetrics& metrics, const CLatencyHistogram* tick, const CLatencyHistogram* dwell) {
+            ThreadRow& row = NextRow(m_threads, m_threadCount);
+            row.m_labels.clear();
+            AppendLabel(row.m_labels, "thread", name);
+            row.m_labels += ',';
+            AppendLabel(row.m_labels, "uuid", uuid);
+            row.m_metrics = metrics;
+            summarize(tick, row.m_tick);
+            summarize(dwell, row.m_dwell);
+        });
+
+    m_queueCount = 0;
+    CMetricsRegistry::Instance().ForEachQueue([&](const std::string& name, const QueueMetricsSnapshot& snapshot, size_t size) {
+        QueueRow& row = NextRow(m_queues, m_queueCount);
+        row.m_labels.clear();
+        AppendLabel(row.m_labels, "queue", name);
+        row.m_snapshot = snapshot;
+        row.m_size = size;
+    });
+
+    m_poolCount = 0;
+    CMetricsRegistry::Instance().ForEachPool([&](const std::string& name, const MessagePoolMetrics& metrics) {
+        PoolRow& row = NextRow(m_pools, m_poolCount);
+        row.m_labels.clear();
+        AppendLabel(row.m_labels, "pool", name);
+        row.m_metrics = metrics;
+    });
+
+    m_histogramCount = 0;
+    CMetricsRegistry::Instance().ForEachHistogram([&](const std::string& name, const CLatencyHistogram& histogram) {
+        HistogramRow& row = NextRow(m_histograms, m_histogramCount);
+        row.m_labels.clear();
+        AppendLabel(row.m_labels, "name", name);
+        summarize(&histogram, row.m_summary);
+    });
+}
+
+void CPrometheusWriter::WriteThreads(std::string& out) const
+{
+    const auto& rows = m_threads;
+    size_t const count = m_threadCount;
+    auto const perfRows = [](const ThreadRow& row) { return row.m_metrics.m_perfAvailable; };
+    AppendFamily(out, "twiz_thread_ticks_total", "counter", "Ticks run by the thread.", rows, count, [](const ThreadRow& row) { return row.m_metrics.m_tickCount; });
+    AppendFamily(out, "twiz_thread_errors_total", "counter", "Errors reported by the thread.", rows, count, [](const ThreadRow& row) { return row.m_metrics.m_errorCount; });
+    AppendFamily(out, "twiz_thread_bytes_processed_total", "counter", "Bytes processed by the thread.", rows, count, [](const ThreadRow& row) { return row.m_metrics.m_bytesProcessed; });
+    AppendFamily(out, "twiz_thread_message_rate", "gauge", "Messages per second reported by the thread.", rows, count, [](const ThreadRow& row) { return row.m_metrics.m_messageRate; });
+    AppendFamily(out, "twiz_thread_last_heartbeat_ms", "gauge", "Tick count (ms) of the last heartbeat.", rows, count, [](const ThreadRow& row) { return row.m_metrics.m_lastHeartbeatEpochMS; });
+    AppendFamily(out, "twiz_thread_cpu", "gauge", "CPU the thread last ran on, -1 if unknown.", rows, count, [](const ThreadRow& row) { return row.m_metrics.m_cpu; });
+    AppendFamily(out, "twiz_thread_cpu_migrations_total", "counter", "CPU changes observed between heartbeats.", rows, count, [](const ThreadRow& row) { return row.m_metrics.m_cpuMigrations; });
+    AppendFamily(out, "twiz_thread_placement_applied", "gauge", "1 if every placement request was honoured.", rows, count, [](const ThreadRow& row) { return row.m_metrics.m_placementApplied; });
+    AppendFamily(out, "twiz_thread_timer_fires_total", "counter", "Timers fired by the scheduler.", rows, count, [](const ThreadRow& row) { return row.m_metrics.m_timerFires; });
+    AppendFamily(out, "twiz_thread_missed_deadlines_total", "counter", "Timer deadlines missed by more than the slack.", rows, count, [](const ThreadRow& row) { return row.m_metrics.m_missedDeadlines; });
+    AppendFamily(out, "twiz_thread_timer_jitter_max_ns", "gauge", "Largest timer lateness.", rows, count, [](const ThreadRow& row) { return row.m_metrics.m_timerJitterMaxNs; });
+    AppendFamily(out, "twiz_thread_wake_latency_max_ns", "gauge", "Largest delay from Wake() to Tick().", rows, count, [](const ThreadRow& row) { return row.m_metrics.m_wakeLatencyMaxNs; });
+    AppendFamily(out, "twiz_thread_idle_parks_total", "counter", "Times the scheduler parked the thread.", rows, count, [](const ThreadRow& row) { return row.m_metrics.m_idleParks; });
+    AppendFamily(out, "twiz_thread_cycles_total", "counter", "CPU cycles (perf_event).", rows, count, [](const ThreadRow& row) { return row.m_metrics.m_cycles; }, perfRows);
+    AppendFamily(out, "twiz_thread_instructions_total", "counter", "Instructions retired (perf_event).", rows, count, [](const ThreadRow& row) { return row.m_metrics.m_instructions; }, perfRows);
+    AppendFamily(out, "twiz_thread_llc_misses_total", "counter", "Last-level cache misses (perf_event).", rows, count, [](const ThreadRow& row) { return row.m_metrics.m_llcMisses; }, perfRows);
+    AppendFamily(out, "twiz_thread_branch_misses_total", "counter", "Branch mispredictions (perf_event).", rows, count, [](const ThreadRow& row) { return row.m_metrics.m_branchMisses; }, perfRows);
+    AppendFamily(out, "twiz_thread_context_switches_total", "counter", "Context switches (perf_event).", rows, count, [](const ThreadRow& row) { return row.m_metrics.m_contextSwitches; }, perfRows);
+    AppendSummaryFamily(out, "twiz_thread_tick_duration_ns", "twiz_thread_tick_duration_ns_sum", "twiz_thread_tick_duration_ns_count", "Tick() duration.", rows, count, [](const ThreadRow& row) -> const Summary& { return row.m_tick; });
+    AppendSummaryFamily(out, "twiz_thread_message_dwell_ns", "twiz_thread_message_dwell_ns_sum", "twiz_thread_message_dwell_ns_count", "Message enqueue-to-dequeue time.", rows, count, [](const ThreadRow& row) -> const Summary& { return row.m_dwell; });
+}
+
+void CPrometheusWriter::WriteQueues(std::string& out) const
+{
+    const auto& rows = m_queues;
+    size_t const count = m_queueCount;
+    AppendFamily(out, "twiz_queue_size", "gauge", "Elements currently queued.", rows, count, [](const QueueRow& row) { return row.m_size; });
+    AppendFamily(out, "twiz_queue_pushes_total", "counter", "Elements pushed.", rows, count, [](const QueueRow& row) { return row.m_snapshot.m_pushes; });
+    AppendFamily(out, "twiz_queue_pops_total", "counter", "Elements popped.", rows, count, [](const QueueRow& row) { return row.m_snapshot.m_pops; });
+    AppendFamily(out, "twiz_queue_full_blocks_total", "counter", "Pushes that waited for space.", rows, count, [](const QueueRow& row) { return row.m_snapshot.m_fullBlocks; });
+    AppendFamily(out, "twiz_queue_empty_blocks_total", "counter", "Pops that waited for an element.", rows, count, [](const QueueRow& row) { return row.m_snapshot.m_emptyBlocks; });
+    AppendFamily(out, "twiz_queue_full_wait_ns_total", "counter", "Time spent waiting for space.", rows, count, [](const QueueRow& row) { return row.m_snapshot.m_fullWaitNs; });
+    AppendFamily(out, "twiz_queue_empty_wait_ns_total", "counter", "Time spent waiting for an element.", rows, count, [](const QueueRow& row) { return row.m_snapshot.m_emptyWaitNs; });
+    AppendFamily(out, "twiz_queue_high_water_mark", "gauge", "Largest size observed after a push.", rows, count, [](const QueueRow& row) { return row.m_snapshot.m_highWaterMark; });
+    AppendFamily(out, "twiz_queue_drops_total", "counter", "Incoming elements discarded by the overflow policy.", rows, count, [](const QueueRow& row) { return row.m_snapshot.m_drops; });
+    AppendFamily(out, "twiz_queue_evictions_total", "counter", "Queued elements discarded to make room.", rows, count, [](const QueueRow& row) { return row.m_snapshot.m_evictions; });
+
+    if (count == 0)
+    {
+        return;
+    }
+    // Power-of-two buckets from QueueMetricsSnapshot.
+    AppendHeader(out, "twiz_queue_dwell_ns", "histogram", "Enqueue-to-dequeue time.");
+    for (size_t i = 0; i < count; ++i)
+    {
+        const QueueRow& row = rows[i];
+        uint64_t cumulative = 0;
+        for (size_t bucket = 0; bucket < Constants::queueDwellBuckets; ++bucket)
+        {
+            cumulative += row.m_snapshot.m_dwellHistogramNs[bucket];
+            std::string_view bound = "le=\"+Inf\"";
+            char le[32] = "le=\"";
+            if (bucket + 1 < Constants::queueDwellBuckets)
+            {
+                auto const result = std::to_chars(le + 4, le + sizeof(le) - 1, uint64_t{1} << bucket);
+                *result.ptr = '"';
+                bound = std::string_view(le, static_cast<size_t>(result.ptr + 1 - le));
+            }
+            AppendSample(out, "twiz_queue_dwell_ns_bucket", row.m_labels, cumulative, bound);
+        }
+        AppendSample(out, "twiz_queue_dwell_ns_sum", row.m_labels, row.m_snapshot.m_dwellSumNs);
+        AppendSample(out, "twiz_queue_dwell_ns_count", row.m_labels, cumulative);
+    }
+}
+
+void CPrometheusWriter::WritePools(std::string& out) const
+{
+    const auto& rows = m_pools;
+    size_t const count = m_poolCount;
+    AppendFamily(out, "twiz_message_pool_hits_total", "counter", "Acquires served from the free list.", rows, count, [](const PoolRow& row) { return row.m_metrics.m_hits; });
+    AppendFamily(out, "twiz_message_pool_misses_total", "counter", "Acquires that allocated a new Message.", rows, count, [](const PoolRow& row) { return row.m_metrics.m_misses; });
+    AppendFamily(out, "twiz_message_pool_recycled_total", "counter", "Messages returned to the free list.", rows, count, [](const PoolRow& row) { return row.m_metrics.m_recycled; });
+    AppendFamily(out, "twiz_message_pool_discarded_total", "counter", "Messages freed because the free list was full.", rows, count, [](const PoolRow& row) { return row.m_metrics.m_discarded; });
+    AppendFamily(out, "twiz_message_pool_size", "gauge", "Messages waiting in the free list.", rows, count, [](const PoolRow& row) { return row.m_metrics.m_available; });
+    AppendFamily(out, "twiz_message_pool_outstanding", "gauge", "Messages handed out and not yet returned.", rows, count, [](const PoolRow& row) { return row.m_metrics.m_outstanding; });
+}
+
+void CPrometheusWriter::WriteHistograms(std::string& out) const
+{
+    AppendSummaryFamily(out, "twiz_latency_ns", "twiz_latency_ns_sum", "twiz_latency_ns_count", "Registered latency histograms.", m_histograms, m_histogramCount,
+                        [](const HistogramRow& row) -> const Summary& { return row.m_summary; });
+}
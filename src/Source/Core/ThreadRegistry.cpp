@@ -0,0 +1,58 @@
+#include "Core/ThreadRegistry.h"
+
+#include <algorithm>
+#include <utility>
+
+CThreadRegistry& CThreadRegistry::Instance()
+{
+    static CThreadRegistry registry;
+    return registry;
+}
+
+void CThreadRegistry::Register(const void* owner, std::string uuid, std::string name, SnapshotFn snapshot, const CLatencyHistogram* tickHistogram, const CLatencyHistogram* dwellHistogram)
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_entries.push_back({owner, std::move(uuid), std::move(name), std::move(snapshot), tickHistogram, dwellHistogram});
+}
+
+void CThreadRegistry::Unregister(const void* owner)
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    std::erase_if(m_entries, [owner](const Entry& entry) { return entry.m_owner == owner; });
+}
+
+ThreadMetricsSummary CThreadRegistry::Aggregate() const
+{
+    ThreadMetricsSummary summary;
+    ForEach([&summary](const std::string& /*uuid*/, const std::string& /*name*/, const ThreadMetrics& metrics) {
+        summary.m_oldestHeartbeatEpochMS = summary.m_threadCount == 0 ? metrics.m_lastHeartbeatEpochMS : std::min(summary.m_oldestHeartbeatEpochMS, metrics.m_lastHeartbeatEpochMS);
+        ++summary.m_threadCount;
+        summary.m_tickCount += metrics.m_tickCount;
+        summary.m_errorCount += metrics.m_errorCount;
+        summary.m_bytesProcessed += metrics.m_bytesProcessed;
+        summary.m_messageRate += metrics.m_messageRate;
+        summary.m_timerFires += metrics.m_timerFires;
+        summary.m_missedDeadlines += metrics.m_missedDeadlines;
+    });
+    return summary;
+}
+
+LatencyHistogramSnapshot CThreadRegistry::MergedTickHistogram() const
+{
+    LatencyHistogramSnapshot merged;
+    ForEachHistogram([&merged](const std::string& /*uuid*/, const std::string& /*name*/, const CLatencyHistogram& tick, const CLatencyHistogram& /*dwell*/) { merged.Merge(tick.Snapshot()); });
+    return merged;
+}
+
+LatencyHistogramSnapshot CThreadRegistry::MergedDwellHistogram() const
+{
+    LatencyHistogramSnapshot merged;
+    ForEachHistogram([&merged](const std::string& /*uuid*/, const std::string& /*name*/, const CLatencyHistogram& /*tick*/, const CLatencyHistogram& dwell) { merged.Merge(dwell.Snapshot()); });
+    return merged;
+}
+
+size_t CThreadRegistry::Size() const
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_entries.size();
+}
@@ -0,0 +1,115 @@
+#include "Core/MessageBatch.h"
+#include "Examples/arena.h"
+#include "Utils/CountingResource.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <jsoncons/json.hpp>
+#include <new>
+#include <vector>
+
+namespace
+{
+    constexpr size_t batchMessages = 1024;
+    constexpr size_t benchBatches = 200;
+    constexpr size_t bookLevels = 5;
+
+    using ArenaJson = jsoncons::pmr::json;
+
+    // Quote-like payload; every string, member and array element is allocated through alloc. The order
+    // reference is long enough to need heap storage of its own.
+    void FillPayload(ArenaMessage& message, size_t i, const ArenaMessage::allocator_type& alloc)
+    {
+        constexpr std::array<const char*, 4> symbols{"AAPL", "MSFT", "NVDA", "AMZN"};
+        message.m_timestamp = 1'700'000'000'000'000'000ULL + i;
+        message.m_id = i;
+        ArenaJson& payload = message.m_payload;
+        payload.try_emplace("symbol", ArenaJson(symbols[i % symbols.size()], alloc));
+        payload.try_emplace("orderRef", ArenaJson("ORD-2024-11-05-XNAS-000000000042", alloc));
+        payload.try_emplace("bid", 189.25 + static_cast<double>(i % 100) * 0.01);
+        payload.try_emplace("ask", 189.27 + static_cast<double>(i % 100) * 0.01);
+        payload.try_emplace("bidSize", static_cast<int64_t>(100 * (i % 7 + 1)));
+        ArenaJson levels(jsoncons::json_array_arg, jsoncons::semantic_tag::none, alloc);
+        for (size_t level = 0; level < bookLevels; ++level)
+        {
+            ArenaJson entry(jsoncons::json_array_arg, jsoncons::semantic_tag::none, alloc);
+            entry.push_back(189.24 - static_cast<double>(level) * 0.01);
+            entry.push_back(static_cast<int64_t>(100 * (level + 1)));
+            levels.push_back(std::move(entry));
+        }
+        payload.try_emplace("levels", std::move(levels));
+    }
+
+    double Bid(const ArenaMessage& message) { return message.m_payload.at("bid").as<double>(); }
+
+    void Report(const char* name, double seconds, const MemoryStats& memory, double checksum)
+    {
+        std::cout << "[arena " << name << ": " << batchMessages << " msgs/batch, " << static_cast<uint64_t>(seconds * 1e9 / benchBatches) << " ns/batch, "
+                  << memory.m_allocations << " allocs over " << benchBatches << " batches, peak " << memory.m_peakBytes / 1024 << " KB, checksum " << static_cast<uint64_t>(checksum) << "]\n";
+    }
+
+    // Baseline: the same pmr payloads straight on the heap, one allocation per node, destroyed one by one.
+    double MeasureHeap()
+    {
+        CCountingResource heap;
+        ArenaMessage::allocator_type const alloc(&heap);
+        std::vector<ArenaMessage*> messages;
+        messages.reserve(batchMessages);
+        double checksum = 0.0;
+
+        auto const start = std::chrono::steady_clock::now();
+        for (size_t batch = 0; batch < benchBatches; ++batch)
+        {
+            for (size_t i = 0; i < batchMessages; ++i)
+            {
+                void* const storage = heap.allocate(sizeof(ArenaMessage), alignof(ArenaMessage));
+                ArenaMessage* const message = ::new (storage) ArenaMessage(alloc);
+                FillPayload(*message, i, alloc);
+                messages.push_back(message);
+            }
+            for (ArenaMessage* message : messages)
+            {
+                checksum += Bid(*message);
+                message->~ArenaMessage();
+                heap.deallocate(message, sizeof(ArenaMessage), alignof(ArenaMessage));
+            }
+            messages.clear();
+        }
+        double const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        Report("heap", seconds, heap.Stats(), checksum);
+        return checksum;
+    }
+
+    double MeasureBatch()
+    {
+        CMessageBatch batch;
+        double checksum = 0.0;
+
+        auto const start = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < benchBatches; ++round)
+        {
+            for (size_t i = 0; i < batchMessages; ++i)
+            {
+                FillPayload(batch.Add(), i, batch.Allocator());
+            }
+            for (const ArenaMessage* message : batch.Messages())
+            {
+                checksum += Bid(*message);
+            }
+            batch.Reset();
+        }
+        double const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        Report("monotonic", seconds, batch.Memory(), checksum);
+        std::cout << "[arena monotonic: retained block " << batch.RetainedBytes() / 1024 << " KB after " << benchBatches << " batches]\n";
+        return checksum;
+    }
+} // namespace
+
+void Twiz::ArenaBenchmark()
+{
+    double const heap = MeasureHeap();
+    double const arena = MeasureBatch();
+    std::cout << "[arena checksums " << (heap == arena ? "match" : "DIFFER") << "]\n";
+}
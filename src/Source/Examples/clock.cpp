@@ -0,0 +1,48 @@
+#include "Examples/clock.h"
+#include "Utils/Clock.h"
+#include "Utils/Utils.h"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace
+{
+    constexpr int clockCalls = 10'000'000;
+
+    template<typename Read>
+    void MeasureCallCost(const std::string& name, Read read)
+    {
+        uint64_t sink = 0;
+        auto const start = std::chrono::steady_clock::now();
+        for (int i = 0; i < clockCalls; ++i)
+        {
+            sink += static_cast<uint64_t>(read());
+        }
+        auto const elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "[" << name << ": " << elapsed / clockCalls << " ns/call, sink " << (sink & 0xff) << "]\n";
+    }
+
+    // Drift of the calibrated clock against CLOCK_MONOTONIC over a short sleep.
+    void MeasureDrift()
+    {
+        int64_t const before = static_cast<int64_t>(Utils::GetTickCountNanos()) - static_cast<int64_t>(Utils::ReadMonotonicNanos());
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        int64_t const after = static_cast<int64_t>(Utils::GetTickCountNanos()) - static_cast<int64_t>(Utils::ReadMonotonicNanos());
+
+        std::cout << "[GetTickCountNanos source: " << (Utils::IsTscClock() ? "TSC" : "vDSO clock_gettime") << ", offset " << before << " ns, drift over 200 ms " << after - before << " ns]\n";
+    }
+} // namespace
+
+void Twiz::ClockBenchmark()
+{
+    Utils::CalibrateClock();
+    MeasureCallCost("Utils::GetTickCountNanos", [] { return Utils::GetTickCountNanos(); });
+    MeasureCallCost("Utils::ReadMonotonicNanos (clock_gettime)", [] { return Utils::ReadMonotonicNanos(); });
+    MeasureCallCost("steady_clock::now", [] { return std::chrono::steady_clock::now().time_since_epoch().count(); });
+    MeasureCallCost("Utils::GetTickCountMillis", [] { return Utils::GetTickCountMillis(); });
+    MeasureDrift();
+    std::cout << "[wall time now: " << Utils::MillisToISO8601UTC(Utils::GetEpochNanos() / 1'000'000) << "]\n";
+}
@@ -0,0 +1,131 @@
+#include "Core/MessageCodec.h"
+#include "Examples/codec.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <jsoncons/json.hpp>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr size_t sampleMessages = 64;
+    constexpr size_t benchRounds = 2'000; // passes over the sample set per format
+    constexpr size_t bookLevels = 5;
+
+    // Quote-like payload: short strings, prices, sizes and a small depth array.
+    std::vector<Message> MakeSamples()
+    {
+        constexpr std::array<const char*, 4> symbols{"AAPL", "MSFT", "NVDA", "AMZN"};
+        std::vector<Message> messages(sampleMessages);
+        for (size_t i = 0; i < messages.size(); ++i)
+        {
+            Message& message = messages[i];
+            message.m_timestamp = 1'700'000'000'000'000'000ULL + i * 1'000;
+            message.m_id = i;
+            message.m_isProcessed = (i % 3) == 0;
+            message.m_payload = jsoncons::json(jsoncons::json_object_arg);
+            message.m_payload["symbol"] = symbols[i % symbols.size()];
+            message.m_payload["venue"] = "XNAS";
+            message.m_payload["bid"] = 189.25 + static_cast<double>(i) * 0.01;
+            message.m_payload["ask"] = 189.27 + static_cast<double>(i) * 0.01;
+            message.m_payload["bidSize"] = static_cast<int64_t>(100 * (i % 7 + 1));
+            message.m_payload["askSize"] = static_cast<int64_t>(100 * (i % 5 + 1));
+            message.m_payload["halted"] = false;
+            jsoncons::json levels(jsoncons::json_array_arg);
+            for (size_t level = 0; level < bookLevels; ++level)
+            {
+                jsoncons::json entry(jsoncons::json_object_arg);
+                entry["price"] = 189.24 - static_cast<double>(level) * 0.01;
+                entry["size"] = static_cast<int64_t>(100 * (level + 1));
+                levels.push_back(std::move(entry));
+            }
+            message.m_payload["levels"] = std::move(levels);
+        }
+        return messages;
+    }
+
+    bool SameMessage(const Message& a, const Message& b)
+    {
+        return a.m_timestamp == b.m_timestamp && a.m_id == b.m_id && a.m_isProcessed == b.m_isProcessed && a.m_payload == b.m_payload;
+    }
+
+    // Encodes and decodes the sample set benchRounds times; reports bytes per message, rates and whether
+    // every message came back identical.
+    void MeasureFormat(PayloadFormat format, const std::vector<Message>& samples)
+    {
+        CMessageCodec const codec(format);
+        std::vector<uint8_t> wire;
+        bool ok = true;
+        for (const Message& message : samples)
+        {
+            ok = codec.Encode(message, wire) && ok;
+        }
+        size_t const bytesPerMessage = wire.size() / samples.size();
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < benchRounds; ++round)
+        {
+            wire.clear();
+            for (const Message& message : samples)
+            {
+                codec.Encode(message, wire);
+            }
+        }
+        double const encodeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        Message decoded;
+        start = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < benchRounds; ++round)
+        {
+            std::span<const uint8_t> rest(wire);
+            while (size_t const used = CMessageCodec::Decode(rest, decoded))
+            {
+                rest = rest.subspan(used);
+            }
+        }
+        double const decodeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::span<const uint8_t> rest(wire);
+        for (const Message& message : samples)
+        {
+            size_t const used = CMessageCodec::Decode(rest, decoded);
+            ok = ok && used != 0 && SameMessage(message, decoded);
+            rest = rest.subspan(used);
+        }
+        ok = ok && rest.empty();
+
+        double const total = static_cast<double>(benchRounds * samples.size());
+        std::cout << "[codec " << CMessageCodec::FormatName(format) << ": " << bytesPerMessage << " B/msg, encode " << static_cast<uint64_t>(total / encodeSeconds) << " msg/s, decode "
+                  << static_cast<uint64_t>(total / decodeSeconds) << " msg/s, round trip " << (ok ? "ok" : "FAILED") << "]\n";
+    }
+
+    // Truncated input and payloads a format cannot carry are rejected rather than misread.
+    void CheckRejects(const std::vector<Message>& samples)
+    {
+        std::vector<uint8_t> wire;
+        CMessageCodec(PayloadFormat::CBOR).Encode(samples.front(), wire);
+        Message decoded;
+        bool ok = CMessageCodec::Decode(std::span<const uint8_t>(wire).first(wire.size() - 1), decoded) == 0;
+        ok = ok && CMessageCodec::Decode(std::span<const uint8_t>(wire).first(CMessageCodec::headerSize - 1), decoded) == 0;
+
+        Message scalar;
+        scalar.m_payload = 42;
+        std::vector<uint8_t> bson;
+        ok = ok && !CMessageCodec(PayloadFormat::BSON).Encode(scalar, bson) && bson.empty();
+        std::cout << "[codec rejects truncated input and non-object BSON: " << (ok ? "ok" : "FAILED") << "]\n";
+    }
+} // namespace
+
+void Twiz::CodecBenchmark()
+{
+    std::vector<Message> const samples = MakeSamples();
+    for (PayloadFormat format : {PayloadFormat::JSON, PayloadFormat::CBOR, PayloadFormat::MSGPACK, PayloadFormat::BSON})
+    {
+        MeasureFormat(format, samples);
+    }
+    CheckRejects(samples);
+}
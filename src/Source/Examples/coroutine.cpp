@@ -0,0 +1,107 @@
+#include "Examples/coroutine.h"
+#include "Core/CoroThreadBase.h"
+#include "Utils/AsyncQueue.h"
+#include "Utils/Coroutine.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr size_t exampleActors = 20'000;
+    constexpr uint64_t messagesPerActor = 50;
+    constexpr size_t inboxCapacity = 8;
+    constexpr size_t schedulerWorkers = 2;
+
+    // One actor per "symbol": sums what it receives and forwards a running total downstream.
+    class CSymbolActor : public CCoroThreadBase<>
+    {
+    public:
+        CSymbolActor(const ThreadProperties& properties, CAsyncQueue<uint64_t>& totals)
+            : CCoroThreadBase(properties)
+            , m_inbox(inboxCapacity)
+            , m_totals(totals)
+        {
+        }
+        ~CSymbolActor() override { Stop(); }
+
+        CAsyncQueue<uint64_t>& Inbox() { return m_inbox; }
+
+    protected:
+        CActorTask Run() override
+        {
+            uint64_t sum = 0;
+            while (std::optional<uint64_t> value = co_await Receive(m_inbox))
+            {
+                sum += *value;
+                m_properties.m_metrics.m_bytesProcessed += sizeof(uint64_t);
+            }
+            co_await m_totals.Push(sum);
+        }
+
+    private:
+        CAsyncQueue<uint64_t> m_inbox;
+        CAsyncQueue<uint64_t>& m_totals;
+    };
+
+    CActorTask Collect(CAsyncQueue<uint64_t>& totals, size_t expected, uint64_t& result)
+    {
+        for (size_t i = 0; i < expected; ++i)
+        {
+            std::optional<uint64_t> total = co_await totals.Pop();
+            if (!total)
+            {
+                break;
+            }
+            result += *total;
+        }
+    }
+} // namespace
+
+// exampleActors actors on schedulerWorkers threads, fed from this thread through bounded inboxes.
+void Twiz::CoroutineExample()
+{
+    CCoroScheduler scheduler(schedulerWorkers);
+    CAsyncQueue<uint64_t> totals(64);
+    uint64_t result = 0;
+    scheduler.Spawn(Collect(totals, exampleActors, result));
+
+    std::vector<std::unique_ptr<CSymbolActor>> actors;
+    actors.reserve(exampleActors);
+    ThreadProperties properties;
+    for (size_t i = 0; i < exampleActors; ++i)
+    {
+        properties.m_name = "sym" + std::to_string(i);
+        actors.push_back(std::make_unique<CSymbolActor>(properties, totals));
+        actors.back()->Start(scheduler);
+    }
+
+    auto const start = std::chrono::steady_clock::now();
+    for (uint64_t round = 0; round < messagesPerActor; ++round)
+    {
+        for (auto& actor : actors)
+        {
+            while (!actor->Inbox().TryPush(round))
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+    for (auto& actor : actors)
+    {
+        actor->Inbox().Close();
+    }
+    scheduler.WaitIdle();
+    auto const elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    LatencyHistogramSnapshot const ticks = scheduler.TickHistogram();
+    uint64_t const expected = exampleActors * (messagesPerActor * (messagesPerActor - 1) / 2);
+    std::cout << "[" << exampleActors << " actors on " << scheduler.WorkerCount() << " workers: " << static_cast<uint64_t>(exampleActors * messagesPerActor / elapsed)
+              << " msg/s, tick p50 " << ticks.Percentile(50.0) << " ns, p99 " << ticks.Percentile(99.0) << " ns, total " << result << (result == expected ? " (ok)" : " (MISMATCH)") << "]\n";
+}
@@ -0,0 +1,170 @@
+#include "Core/MessageLog.h"
+#include "Examples/messagelog.h"
+#include "Utils/SpscQueue.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <system_error>
+#include <thread>
+
+namespace
+{
+    constexpr size_t logMessages = 20'000;
+    constexpr size_t segmentBytes = 1024 * 1024; // small, so the run rolls over several segments
+    constexpr uint64_t firstTimestamp = 1'000'000'000;
+    constexpr uint64_t timestampStep = 100'000; // 100 us between recorded messages
+    constexpr uint64_t firstId = 5'000;
+    constexpr size_t seekProbes = 10'000;
+    constexpr size_t replayWindow = 500;        // 50 ms of recorded time
+    constexpr size_t queueCapacity = 1024;
+
+    using Clock = std::chrono::steady_clock;
+
+    // The log stores wall time, so seeks and end bounds convert the tick values MakeMessage stamps.
+    uint64_t RecordedTimestamp(size_t i) { return Utils::TickNanosToEpochNanos(firstTimestamp + i * timestampStep); }
+
+    Message MakeMessage(size_t i)
+    {
+        constexpr std::array<const char*, 4> symbols{"AAPL", "MSFT", "NVDA", "AMZN"};
+        Message message;
+        message.m_timestamp = firstTimestamp + i * timestampStep;
+        message.m_id = firstId + i;
+        message.m_payload["symbol"] = symbols[i % symbols.size()];
+        message.m_payload["bid"] = 189.25 + static_cast<double>(i % 100) * 0.01;
+        message.m_payload["ask"] = 189.27 + static_cast<double>(i % 100) * 0.01;
+        message.m_payload["size"] = static_cast<int64_t>(100 * (i % 7 + 1));
+        return message;
+    }
+
+    double Seconds(Clock::time_point start) { return std::chrono::duration<double>(Clock::now() - start).count(); }
+
+    // Appends the capture, then leaves a half-written record behind the last one, as a crash mid-append would.
+    bool WriteLog(const std::filesystem::path& directory)
+    {
+        CMessageLog log(directory, segmentBytes);
+        bool ok = log.Open();
+        auto const start = Clock::now();
+        for (size_t i = 0; i < logMessages; ++i)
+        {
+            ok = log.Append(MakeMessage(i)) && ok;
+        }
+        double const seconds = Seconds(start);
+        ok = ok && log.Flush(true);
+        std::cout << "[log append: " << logMessages << " msgs in " << log.SegmentCount() << " segments, " << static_cast<uint64_t>(static_cast<double>(logMessages) / seconds)
+                  << " msg/s " << (ok && log.SegmentCount() > 1 ? "ok" : "FAILED") << "]\n";
+
+        std::filesystem::path const segment = log.SegmentPath();
+        size_t const tail = log.WriteOffset();
+        log.Close();
+        std::fstream file(segment, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(tail));
+        std::array<char, 40> const torn{120, 0, 0, 0, 0x5a, 0x5a, 0x5a, 0x5a, 'p', 'a', 'r', 't', 'i', 'a', 'l'};
+        file.write(torn.data(), torn.size());
+        return ok;
+    }
+
+    bool RecoverLog(const std::filesystem::path& directory)
+    {
+        CMessageLog log(directory, segmentBytes);
+        bool ok = log.Open() && log.RecordCount() == logMessages && log.RecoveredBytes() > 0;
+        size_t const recovered = log.RecoveredBytes();
+        ok = ok && log.Append(MakeMessage(logMessages)) && log.RecordCount() == logMessages + 1;
+        std::cout << "[log recovery: truncated " << recovered << " torn bytes, appends resume at record " << logMessages << " " << (ok ? "ok" : "FAILED") << "]\n";
+        return ok;
+    }
+
+    void ReadLog(const std::filesystem::path& directory)
+    {
+        size_t const records = logMessages + 1;
+        CMessageLogReader reader(directory);
+        bool ok = reader.Open() && reader.RecordCount() == records;
+
+        // Zero-copy pass: headers only, payloads stay in the mapping.
+        LogRecord record;
+        uint64_t expectedId = firstId;
+        auto start = Clock::now();
+        while (reader.Next(record))
+        {
+            ok = ok && record.m_header.m_id == expectedId++;
+        }
+        double const scanRate = static_cast<double>(records) / Seconds(start);
+        ok = ok && expectedId == firstId + records;
+
+        std::mt19937_64 random(42);
+        std::uniform_int_distribution<size_t> pick(0, records - 1);
+        start = Clock::now();
+        for (size_t probe = 0; probe < seekProbes; ++probe)
+        {
+            size_t const i = pick(random);
+            bool const byTime = (probe & 1) != 0;
+            bool const found = byTime ? reader.SeekTimestamp(RecordedTimestamp(i) - timestampStep / 2) : reader.SeekId(firstId + i);
+            ok = ok && found && reader.Next(record) && record.m_header.m_id == firstId + i;
+        }
+        double const seekNanos = Seconds(start) * 1e9 / static_cast<double>(seekProbes);
+        ok = ok && !reader.SeekId(firstId + records);
+
+        std::cout << "[log read: " << records << " records, " << reader.Index().size() << " index entries, scan " << static_cast<uint64_t>(scanRate) << " rec/s, seek "
+                  << static_cast<uint64_t>(seekNanos) << " ns " << (ok ? "ok" : "FAILED") << "]\n";
+    }
+
+    // Replays replayWindow records from the middle of the log; the queue is drained as it fills.
+    void Replay(const std::filesystem::path& directory, const char* label, double speed, size_t expected)
+    {
+        CMessageLogReader reader(directory);
+        CQueue<Message, SpscRing> queue(queueCapacity);
+        size_t received = 0;
+        uint64_t expectedId = firstId + logMessages / 2;
+        bool ordered = true;
+        std::thread consumer(
+            [&]
+            {
+                Message message;
+                while (queue.PopValue(message))
+                {
+                    ordered = ordered && message.m_id == expectedId++;
+                    ++received;
+                }
+            });
+
+        uint64_t const from = RecordedTimestamp(logMessages / 2);
+        bool ok = reader.Open() && reader.SeekTimestamp(from);
+        ReplayOptions options;
+        options.m_speed = speed;
+        options.m_endTimestamp = expected == replayWindow ? from + replayWindow * timestampStep : options.m_endTimestamp;
+        auto const start = Clock::now();
+        size_t const pushed = reader.Replay(queue, options);
+        double const seconds = Seconds(start);
+        queue.Close();
+        consumer.join();
+        ok = ok && pushed == expected && received == expected && ordered;
+
+        std::cout << "[log replay " << label << ": " << pushed << " msgs in " << static_cast<uint64_t>(seconds * 1e3) << " ms";
+        if (speed > 0.0)
+        {
+            std::cout << " (recorded " << static_cast<uint64_t>(static_cast<double>((expected - 1) * timestampStep) / 1e6) << " ms)";
+        }
+        std::cout << " " << (ok ? "ok" : "FAILED") << "]\n";
+    }
+} // namespace
+
+void Twiz::MessageLogBenchmark()
+{
+    std::filesystem::path const directory = std::filesystem::temp_directory_path() / "twiz_message_log";
+    std::error_code ignored;
+    std::filesystem::remove_all(directory, ignored);
+
+    if (WriteLog(directory) && RecoverLog(directory))
+    {
+        ReadLog(directory);
+        Replay(directory, "1x", 1.0, replayWindow);
+        Replay(directory, "5x", 5.0, replayWindow);
+        Replay(directory, "max", 0.0, logMessages + 1 - logMessages / 2);
+    }
+
+    std::filesystem::remove_all(directory, ignored);
+}
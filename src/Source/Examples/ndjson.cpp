@@ -0,0 +1,108 @@
+#include "Core/NdjsonIngester.h"
+#include "Examples/ndjson.h"
+#include "Utils/QueueMetrics.h"
+#include "Utils/SpscQueue.h"
+#include "Utils/WaitPolicy.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace
+{
+    constexpr size_t inputLines = 50'000;
+    constexpr size_t queueCapacity = 256;
+    constexpr size_t bookLevels = 20;
+    constexpr size_t malformedEvery = 10'000; // one broken line per this many, plus blank lines
+
+    using IngestQueue = CQueue<Message, SpscRing, ParkWait, CQueueMetrics>;
+
+    // Quote lines with a deep order book and an audit blob, the subtrees a projection drops.
+    size_t WriteInput(const std::filesystem::path& path)
+    {
+        constexpr std::array<const char*, 4> symbols{"AAPL", "MSFT", "NVDA", "AMZN"};
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        size_t malformed = 0;
+        for (size_t i = 0; i < inputLines; ++i)
+        {
+            out << R"({"seq":)" << 1'000'000 + i << R"(,"symbol":")" << symbols[i % symbols.size()] << R"(","bid":)" << 189.25 + static_cast<double>(i % 100) * 0.01
+                << R"(,"ask":)" << 189.27 + static_cast<double>(i % 100) * 0.01 << R"(,"book":[)";
+            for (size_t level = 0; level < bookLevels; ++level)
+            {
+                out << (level ? "," : "") << R"({"price":)" << 189.24 - static_cast<double>(level) * 0.01 << R"(,"size":)" << 100 * (level + 1) << "}";
+            }
+            out << R"(],"audit":{"source":"feed-a","session":"2024-11-05","tags":["l2","snapshot"],"note":"venue XNAS, conflated"}})" << '\n';
+            if (i % malformedEvery == 0)
+            {
+                out << R"({"seq":1,"symbol":"BROKEN",)" << "\n\n";
+                ++malformed;
+            }
+        }
+        return malformed;
+    }
+
+    struct RunResult
+    {
+        NdjsonStats m_stats;
+        uint64_t m_highWaterMark{};
+        double m_seconds{};
+        bool m_ok{true};
+    };
+
+    RunResult Run(const std::filesystem::path& path, NdjsonOptions options, size_t expectedMembers)
+    {
+        IngestQueue queue(queueCapacity);
+        RunResult result;
+        std::thread consumer(
+            [&]
+            {
+                Message message;
+                uint64_t expectedId = 1'000'000;
+                while (queue.PopValue(message))
+                {
+                    bool const idOk = options.m_idField.empty() || message.m_id == expectedId;
+                    result.m_ok = result.m_ok && idOk && message.m_payload.is_object() && message.m_payload.size() == expectedMembers;
+                    ++expectedId;
+                }
+            });
+
+        CNdjsonIngester ingester(options);
+        auto const start = std::chrono::steady_clock::now();
+        bool const ingested = ingester.IngestFile(path.string(), queue);
+        queue.Close();
+        consumer.join();
+        result.m_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.m_stats = ingester.Stats();
+        result.m_highWaterMark = queue.GetMetrics().Snapshot().m_highWaterMark;
+        result.m_ok = result.m_ok && ingested && result.m_stats.m_messages == inputLines && result.m_highWaterMark <= queueCapacity;
+        return result;
+    }
+
+    void Report(const char* label, const RunResult& result, size_t expectedMalformed)
+    {
+        bool const ok = result.m_ok && result.m_stats.m_malformed == expectedMalformed;
+        double const mb = static_cast<double>(result.m_stats.m_bytes) / (1024.0 * 1024.0);
+        std::cout << "[ndjson " << label << ": " << result.m_stats.m_messages << " msgs, " << result.m_stats.m_malformed << " malformed, "
+                  << static_cast<uint64_t>(static_cast<double>(result.m_stats.m_messages) / result.m_seconds) << " msg/s, " << static_cast<uint64_t>(mb / result.m_seconds)
+                  << " MB/s, queue high-water " << result.m_highWaterMark << "/" << queueCapacity << " " << (ok ? "ok" : "FAILED") << "]\n";
+    }
+} // namespace
+
+void Twiz::NdjsonIngestBenchmark()
+{
+    std::filesystem::path const path = std::filesystem::temp_directory_path() / "twiz_ingest.ndjson";
+    size_t const malformed = WriteInput(path);
+
+    // Whole lines: seq, symbol, bid, ask, book, audit.
+    Report("full", Run(path, {}, 6), malformed);
+    Report("projected", Run(path, {.m_fields = {"symbol", "bid", "ask"}, .m_idField = "seq"}, 3), malformed);
+
+    std::error_code ignored;
+    std::filesystem::remove(path, ignored);
+}
@@ -0,0 +1,115 @@
+#include "Examples/pipeline.h"
+#include "Core/Pipeline.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace
+{
+    constexpr uint64_t exampleItems = 200'000;
+    constexpr int slowWorkerSpin = 200;
+    constexpr int reportRounds = 3;
+
+    ThreadProperties Named(const std::string& name)
+    {
+        ThreadProperties properties;
+        properties.m_name = name;
+        return properties;
+    }
+
+    class CCounterSource : public CPipelineSource<uint64_t>
+    {
+    public:
+        using CPipelineSource::CPipelineSource;
+
+    protected:
+        bool Produce() override
+        {
+            for (size_t i = 0; i < Constants::pipelineBatch && m_next < exampleItems; ++i)
+            {
+                Emit(m_next++);
+            }
+            return m_next < exampleItems;
+        }
+
+    private:
+        uint64_t m_next{0};
+    };
+
+    // Squares its input; spin > 0 simulates a slower worker.
+    class CSquareStage : public CPipelineStage<uint64_t, uint64_t>
+    {
+    public:
+        CSquareStage(const ThreadProperties& properties, int spin)
+            : CPipelineStage(properties)
+            , m_spin(spin)
+        {
+        }
+
+    protected:
+        void Process(uint64_t& item) override
+        {
+            for (int i = 0; i < m_spin; ++i)
+            {
+                Utils::CpuRelax();
+            }
+            Emit(item * item);
+        }
+
+    private:
+        int m_spin;
+    };
+
+    class CSumSink : public CPipelineSink<uint64_t>
+    {
+    public:
+        using CPipelineSink::CPipelineSink;
+
+        [[nodiscard]] uint64_t Sum() const { return m_sum.load(); }
+        [[nodiscard]] uint64_t Count() const { return m_count.load(); }
+
+    protected:
+        void Consume(uint64_t& item) override
+        {
+            m_sum.fetch_add(item, std::memory_order_relaxed);
+            m_count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<uint64_t> m_sum{0};
+        std::atomic<uint64_t> m_count{0};
+    };
+} // namespace
+
+// source -> partition -> {fast, slow} -> merge -> sink. The slow worker's edge should show up as saturated.
+void Twiz::PipelineExample()
+{
+    CPipeline pipeline;
+    auto& source = pipeline.Add<CCounterSource>(Named("source"));
+    auto& fast = pipeline.Add<CSquareStage>(Named("square-fast"), 0);
+    auto& slow = pipeline.Add<CSquareStage>(Named("square-slow"), slowWorkerSpin);
+    auto& sink = pipeline.Add<CSumSink>(Named("sum"));
+
+    source.SetFanOut(FanOut::PARTITION, [](const uint64_t& value) { return static_cast<size_t>(value); });
+    pipeline.Connect(source, fast);
+    pipeline.Connect(source, slow);
+    pipeline.Connect(fast, sink);
+    pipeline.Connect(slow, sink);
+
+    if (!pipeline.Start())
+    {
+        return;
+    }
+    for (int round = 0; round < reportRounds && sink.Count() < exampleItems; ++round)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        pipeline.Report().Print(std::cout);
+    }
+    pipeline.Wait();
+    pipeline.Report().Print(std::cout);
+
+    std::cout << "[pipeline delivered " << sink.Count() << "/" << exampleItems << " items, sum " << sink.Sum() << "]\n";
+}
@@ -0,0 +1,179 @@
+#include "Examples/queue.h"
+#include "Utils/MpmcQueue.h"
+#include "Utils/Queue.h"
+#include "Utils/SpscQueue.h"
+#include "Utils/WaitPolicy.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr size_t benchCapacity = 1024;
+    constexpr uint64_t throughputItems = 2'000'000;
+    constexpr int latencyRounds = 100'000;
+    constexpr int contendedProducers = 8;
+    constexpr int contendedConsumers = 2;
+    constexpr size_t bulkBatch = 256;
+
+    template<typename Queue>
+    void MeasureThroughput(const std::string& name)
+    {
+        Queue queue(benchCapacity);
+        uint64_t sum = 0;
+
+        auto const start = std::chrono::steady_clock::now();
+        std::thread consumer([&] {
+            uint64_t value = 0;
+            while (queue.PopValue(value))
+            {
+                sum += value;
+            }
+        });
+        for (uint64_t i = 0; i < throughputItems; ++i)
+        {
+            queue.Push(i);
+        }
+        queue.Close();
+        consumer.join();
+        auto const elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "[" << name << " throughput: " << static_cast<uint64_t>(throughputItems / elapsed) << " ops/s, checksum " << sum << "]\n";
+    }
+
+    // Ping-pong between two queues; one-way latency is half the round trip.
+    template<typename Queue>
+    void MeasureLatency(const std::string& name)
+    {
+        Queue ping(benchCapacity);
+        Queue pong(benchCapacity);
+        std::vector<int64_t> samples;
+        samples.reserve(latencyRounds);
+
+        std::thread echo([&] {
+            uint64_t value = 0;
+            while (ping.PopValue(value))
+            {
+                pong.Push(value);
+            }
+            pong.Close();
+        });
+        for (int i = 0; i < latencyRounds; ++i)
+        {
+            uint64_t value = 0;
+            auto const start = std::chrono::steady_clock::now();
+            ping.Push(static_cast<uint64_t>(i));
+            pong.PopValue(value);
+            samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() / 2);
+        }
+        ping.Close();
+        echo.join();
+
+        std::sort(samples.begin(), samples.end());
+        std::cout << "[" << name << " latency: p50 " << samples[samples.size() / 2] << " ns, p99 " << samples[samples.size() * 99 / 100] << " ns, max " << samples.back() << " ns]\n";
+    }
+
+    // Same transfer as MeasureThroughput, moved in batches of bulkBatch with PushBulk/PopBulk.
+    template<typename Queue>
+    void MeasureBulkThroughput(const std::string& name)
+    {
+        Queue queue(benchCapacity);
+        uint64_t sum = 0;
+
+        auto const start = std::chrono::steady_clock::now();
+        std::thread consumer([&] {
+            std::vector<uint64_t> batch(bulkBatch);
+            size_t count = 0;
+            while ((count = queue.PopBulk(batch.begin(), bulkBatch)) > 0)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    sum += batch[i];
+                }
+            }
+        });
+        std::vector<uint64_t> batch(bulkBatch);
+        for (uint64_t i = 0; i < throughputItems; i += bulkBatch)
+        {
+            auto const count = static_cast<size_t>(std::min<uint64_t>(bulkBatch, throughputItems - i));
+            for (size_t j = 0; j < count; ++j)
+            {
+                batch[j] = i + j;
+            }
+            queue.PushBulk(batch.begin(), batch.begin() + static_cast<std::ptrdiff_t>(count));
+        }
+        queue.Close();
+        consumer.join();
+        auto const elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "[" << name << " bulk(" << bulkBatch << ") throughput: " << static_cast<uint64_t>(throughputItems / elapsed) << " ops/s, checksum " << sum << "]\n";
+    }
+
+    // Several producers and consumers hammering one shared queue.
+    template<typename Queue>
+    void MeasureContention(const std::string& name)
+    {
+        Queue queue(benchCapacity);
+        std::atomic<uint64_t> sum{0};
+        uint64_t const perProducer = throughputItems / contendedProducers;
+
+        auto const start = std::chrono::steady_clock::now();
+        std::vector<std::thread> consumers;
+        for (int c = 0; c < contendedConsumers; ++c)
+        {
+            consumers.emplace_back([&] {
+                uint64_t value = 0;
+                uint64_t local = 0;
+                while (queue.PopValue(value))
+                {
+                    local += value;
+                }
+                sum.fetch_add(local);
+            });
+        }
+        std::vector<std::thread> producers;
+        for (int p = 0; p < contendedProducers; ++p)
+        {
+            producers.emplace_back([&] {
+                for (uint64_t i = 0; i < perProducer; ++i)
+                {
+                    queue.Push(i);
+                }
+            });
+        }
+        for (auto& producer : producers)
+        {
+            producer.join();
+        }
+        queue.Close();
+        for (auto& consumer : consumers)
+        {
+            consumer.join();
+        }
+        auto const elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "[" << name << " " << contendedProducers << "P/" << contendedConsumers << "C throughput: " << static_cast<uint64_t>(perProducer * contendedProducers / elapsed)
+                  << " ops/s, checksum " << sum.load() << "]\n";
+    }
+} // namespace
+
+void Twiz::QueueBenchmark()
+{
+    MeasureThroughput<CQueue<uint64_t>>("CQueue<deque>");
+    MeasureThroughput<CQueue<uint64_t, SpscRing>>("CQueue<SpscRing>");
+    MeasureBulkThroughput<CQueue<uint64_t>>("CQueue<deque>");
+    MeasureLatency<CQueue<uint64_t>>("CQueue<deque>");
+    MeasureLatency<CQueue<uint64_t, SpscRing>>("CQueue<SpscRing>");
+    MeasureLatency<CQueue<uint64_t, std::deque<uint64_t>, SpinParkWait<>>>("CQueue<deque, SpinParkWait>");
+    MeasureLatency<CQueue<uint64_t, SpscRing, SpinParkWait<>>>("CQueue<SpscRing, SpinParkWait>");
+    MeasureLatency<CQueue<uint64_t, SpscRing, SpinYieldWait<>>>("CQueue<SpscRing, SpinYieldWait>");
+    MeasureContention<CQueue<uint64_t>>("CQueue<deque>");
+    MeasureContention<CQueue<uint64_t, MpmcRing>>("CQueue<MpmcRing>");
+}
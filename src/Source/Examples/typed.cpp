@@ -0,0 +1,141 @@
+#include "Core/MessageCodec.h"
+#include "Core/TypedMessage.h"
+#include "Examples/typed.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <jsoncons/json.hpp>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr size_t sampleMessages = 64;
+    constexpr size_t benchRounds = 2'000; // passes over the sample set per format and path
+    constexpr size_t bookLevels = 5;
+
+    struct Level
+    {
+        double m_price{};
+        int64_t m_size{};
+
+        bool operator==(const Level&) const = default;
+    };
+
+    struct Quote
+    {
+        std::string m_symbol;
+        std::string m_venue;
+        double m_bid{};
+        double m_ask{};
+        int64_t m_bidSize{};
+        int64_t m_askSize{};
+        bool m_halted{false};
+        std::vector<Level> m_levels;
+
+        bool operator==(const Quote&) const = default;
+    };
+} // namespace
+
+// Same names and shapes as the dynamic payload of Twiz::CodecBenchmark, book levels included, so either
+// side can decode the other's bytes.
+JSONCONS_ALL_MEMBER_NAME_TRAITS(Level, (m_price, "price"), (m_size, "size"))
+JSONCONS_ALL_MEMBER_NAME_TRAITS(Quote, (m_symbol, "symbol"), (m_venue, "venue"), (m_bid, "bid"), (m_ask, "ask"), (m_bidSize, "bidSize"), (m_askSize, "askSize"), (m_halted, "halted"),
+                                (m_levels, "levels"))
+
+namespace
+{
+    std::vector<TypedMessage<Quote>> MakeSamples()
+    {
+        constexpr std::array<const char*, 4> symbols{"AAPL", "MSFT", "NVDA", "AMZN"};
+        std::vector<TypedMessage<Quote>> messages(sampleMessages);
+        for (size_t i = 0; i < messages.size(); ++i)
+        {
+            TypedMessage<Quote>& message = messages[i];
+            message.m_timestamp = 1'700'000'000'000'000'000ULL + i * 1'000;
+            message.m_id = i;
+            message.m_isProcessed = (i % 3) == 0;
+            Quote& quote = message.m_payload;
+            quote.m_symbol = symbols[i % symbols.size()];
+            quote.m_venue = "XNAS";
+            quote.m_bid = 189.25 + static_cast<double>(i) * 0.01;
+            quote.m_ask = 189.27 + static_cast<double>(i) * 0.01;
+            quote.m_bidSize = static_cast<int64_t>(100 * (i % 7 + 1));
+            quote.m_askSize = static_cast<int64_t>(100 * (i % 5 + 1));
+            for (size_t level = 0; level < bookLevels; ++level)
+            {
+                quote.m_levels.push_back({189.24 - static_cast<double>(level) * 0.01, static_cast<int64_t>(100 * (level + 1))});
+            }
+        }
+        return messages;
+    }
+
+    // Decodes the whole buffer benchRounds times, reading the same two fields each path would route on.
+    template<typename MessageT, typename Decode, typename Read>
+    double MeasureDecode(const std::vector<uint8_t>& wire, Decode decode, Read read, double& checksum)
+    {
+        MessageT message;
+        checksum = 0.0;
+        auto const start = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < benchRounds; ++round)
+        {
+            std::span<const uint8_t> rest(wire);
+            while (size_t const used = decode(rest, message))
+            {
+                checksum += read(message);
+                rest = rest.subspan(used);
+            }
+        }
+        double const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return static_cast<double>(benchRounds * sampleMessages) / seconds;
+    }
+
+    void MeasureFormat(PayloadFormat format, const std::vector<TypedMessage<Quote>>& samples)
+    {
+        CTypedCodec<Quote> const codec(format);
+        std::vector<uint8_t> wire;
+        bool ok = true;
+        for (const TypedMessage<Quote>& message : samples)
+        {
+            ok = codec.Encode(message, wire) && ok;
+        }
+
+        double dynamicSum = 0.0;
+        double const dynamicRate = MeasureDecode<Message>(
+            wire, [](std::span<const uint8_t> bytes, Message& message) { return CMessageCodec::Decode(bytes, message); },
+            [](const Message& message) { return message.m_payload.at("bid").as<double>() + static_cast<double>(message.m_payload.at("bidSize").as<int64_t>()); }, dynamicSum);
+
+        double typedSum = 0.0;
+        double const typedRate = MeasureDecode<TypedMessage<Quote>>(
+            wire, [](std::span<const uint8_t> bytes, TypedMessage<Quote>& message) { return CTypedCodec<Quote>::Decode(bytes, message); },
+            [](const TypedMessage<Quote>& message) { return message.m_payload.m_bid + static_cast<double>(message.m_payload.m_bidSize); }, typedSum);
+
+        std::span<const uint8_t> rest(wire);
+        TypedMessage<Quote> decoded;
+        for (const TypedMessage<Quote>& message : samples)
+        {
+            size_t const used = CTypedCodec<Quote>::Decode(rest, decoded);
+            ok = ok && used != 0 && decoded.m_payload == message.m_payload && decoded.m_id == message.m_id && decoded.m_timestamp == message.m_timestamp &&
+                 decoded.m_isProcessed == message.m_isProcessed;
+            rest = rest.subspan(used);
+        }
+        ok = ok && rest.empty() && dynamicSum == typedSum;
+
+        std::cout << "[typed " << CMessageCodec::FormatName(format) << ": decode json DOM " << static_cast<uint64_t>(dynamicRate) << " msg/s, typed " << static_cast<uint64_t>(typedRate)
+                  << " msg/s (" << std::fixed << std::setprecision(2) << (dynamicRate > 0.0 ? typedRate / dynamicRate : 0.0) << std::defaultfloat << "x), round trip "
+                  << (ok ? "ok" : "FAILED") << "]\n";
+    }
+} // namespace
+
+void Twiz::TypedMessageBenchmark()
+{
+    std::vector<TypedMessage<Quote>> const samples = MakeSamples();
+    for (PayloadFormat format : {PayloadFormat::JSON, PayloadFormat::CBOR, PayloadFormat::MSGPACK, PayloadFormat::BSON})
+    {
+        MeasureFormat(format, samples);
+    }
+}
@@ -0,0 +1,108 @@
+#include "Utils/Clock.h"
+#include "Constants.h"
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+
+#ifdef TWIZ_TSC_CLOCK
+#include <cpuid.h>
+#endif
+
+namespace Utils
+{
+
+    namespace
+    {
+#if defined(_WIN32)
+        enum ClockId
+        {
+            CLOCK_MONOTONIC,
+            CLOCK_REALTIME
+        };
+
+        uint64_t ReadClock(ClockId clock) noexcept
+        {
+            if (clock == CLOCK_REALTIME)
+            {
+                return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+            }
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+#else
+        uint64_t ReadClock(clockid_t clock) noexcept
+        {
+            timespec ts{};
+            clock_gettime(clock, &ts);
+            return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ULL + static_cast<uint64_t>(ts.tv_nsec);
+        }
+#endif
+
+#ifdef TWIZ_TSC_CLOCK
+        // CPUID.80000007H:EDX[8]: the TSC ticks at a constant rate across P-, C- and T-states.
+        bool HasInvariantTsc() noexcept
+        {
+            unsigned eax = 0;
+            unsigned ebx = 0;
+            unsigned ecx = 0;
+            unsigned edx = 0;
+            if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007 || !__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+            {
+                return false;
+            }
+            return (edx & (1U << 8)) != 0;
+        }
+
+        // TSC reading taken at the midpoint of a clock read.
+        void SampleTsc(uint64_t& tsc, uint64_t& nanos) noexcept
+        {
+            uint64_t const before = __rdtsc();
+            nanos = ReadClock(CLOCK_MONOTONIC);
+            uint64_t const after = __rdtsc();
+            tsc = before + (after - before) / 2;
+        }
+#endif
+    } // namespace
+
+    uint64_t ReadMonotonicNanos() noexcept
+    {
+        return ReadClock(CLOCK_MONOTONIC);
+    }
+
+    ClockCalibration MeasureClockCalibration()
+    {
+        ClockCalibration calibration;
+        uint64_t const monoBefore = ReadClock(CLOCK_MONOTONIC);
+        uint64_t const real = ReadClock(CLOCK_REALTIME);
+        uint64_t const monoAfter = ReadClock(CLOCK_MONOTONIC);
+        calibration.m_wallOffsetNs = static_cast<int64_t>(real) - static_cast<int64_t>(monoBefore + (monoAfter - monoBefore) / 2);
+
+#ifdef TWIZ_TSC_CLOCK
+        if (!HasInvariantTsc())
+        {
+            return calibration;
+        }
+        uint64_t tscStart = 0;
+        uint64_t nanosStart = 0;
+        uint64_t tscEnd = 0;
+        uint64_t nanosEnd = 0;
+        SampleTsc(tscStart, nanosStart);
+        uint64_t const window = static_cast<uint64_t>(Constants::clockCalibrationMs) * 1'000'000;
+        do
+        {
+            SampleTsc(tscEnd, nanosEnd);
+        } while (nanosEnd - nanosStart < window);
+        if (tscEnd <= tscStart)
+        {
+            return calibration;
+        }
+        double const nanosPerTick = static_cast<double>(nanosEnd - nanosStart) / static_cast<double>(tscEnd - tscStart);
+        calibration.m_multiplier = static_cast<uint64_t>(nanosPerTick * 4294967296.0 + 0.5);
+        calibration.m_tscBase = tscEnd;
+        calibration.m_nanosBase = nanosEnd;
+        calibration.m_useTsc = true;
+#endif
+        return calibration;
+    }
+
+} // namespace Utils
@@ -0,0 +1,98 @@
+#include "Utils/Coroutine.h"
+#include "Core/MetricsRegistry.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+CCoroScheduler::CCoroScheduler(size_t workerCount, std::string name)
+    : m_name(std::move(name))
+    , m_executor(std::max<size_t>(workerCount, 1))
+{
+    // Filled before any actor is spawned, so workers never see the vector grow.
+    for (size_t i = 0; i < m_executor.WorkerCount(); ++i)
+    {
+        m_histograms.push_back(std::make_unique<WorkerHistograms>());
+        std::string const prefix = m_name + ".w" + std::to_string(i);
+        CMetricsRegistry::Instance().RegisterHistogram(m_histograms.back()->m_tick, prefix + ".tick");
+        CMetricsRegistry::Instance().RegisterHistogram(m_histograms.back()->m_dwell, prefix + ".dwell");
+    }
+}
+
+CCoroScheduler::~CCoroScheduler()
+{
+    Stop();
+    for (const auto& histograms : m_histograms)
+    {
+        CMetricsRegistry::Instance().Unregister(&histograms->m_tick);
+        CMetricsRegistry::Instance().Unregister(&histograms->m_dwell);
+    }
+}
+
+void CCoroScheduler::Spawn(CActorTask task)
+{
+    std::coroutine_handle<CActorTask::promise_type> const handle = task.Release();
+    handle.promise().m_scheduler = this;
+    m_live.fetch_add(1, std::memory_order_relaxed);
+    Schedule(&handle.promise().m_resumeJob);
+}
+
+void CCoroScheduler::WaitIdle()
+{
+    size_t live = m_live.load(std::memory_order_acquire);
+    while (live != 0)
+    {
+        m_live.wait(live, std::memory_order_acquire);
+        live = m_live.load(std::memory_order_acquire);
+    }
+}
+
+void CCoroScheduler::Stop() { m_executor.Stop(); }
+
+void CCoroScheduler::OnActorDone()
+{
+    if (m_live.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        m_live.notify_all();
+    }
+}
+
+void CCoroScheduler::RecordTick(uint64_t durationNs)
+{
+    if (std::optional<size_t> const worker = m_executor.CurrentWorker())
+    {
+        m_histograms[*worker]->m_tick.Record(durationNs);
+    }
+}
+
+void CCoroScheduler::RecordDwell(uint64_t dwellNs)
+{
+    if (std::optional<size_t> const worker = m_executor.CurrentWorker())
+    {
+        m_histograms[*worker]->m_dwell.Record(dwellNs);
+    }
+}
+
+LatencyHistogramSnapshot CCoroScheduler::TickHistogram() const
+{
+    LatencyHistogramSnapshot merged;
+    for (const auto& histograms : m_histograms)
+    {
+        merged.Merge(histograms->m_tick.Snapshot());
+    }
+    return merged;
+}
+
+LatencyHistogramSnapshot CCoroScheduler::DwellHistogram() const
+{
+    LatencyHistogramSnapshot merged;
+    for (const auto& histograms : m_histograms)
+    {
+        merged.Merge(histograms->m_dwell.Snapshot());
+    }
+    return merged;
+}
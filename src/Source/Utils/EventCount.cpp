@@ -0,0 +1,66 @@
+#include "Utils/EventCount.h"
+
+#include <algorithm>
+#include <climits>
+#include <thread>
+
+#ifdef __linux__
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free, "the futex word is the atomic itself");
+#endif
+
+bool CEventCount::Wait(Key key, std::chrono::nanoseconds timeout) noexcept
+{
+    auto const deadline = std::chrono::steady_clock::now() + timeout;
+    bool notified = true;
+    while (m_epoch.load(std::memory_order_acquire) == key)
+    {
+        auto const now = std::chrono::steady_clock::now();
+        if (now >= deadline)
+        {
+            notified = false;
+            break;
+        }
+        Block(key, std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count());
+    }
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    return notified;
+}
+
+void CEventCount::Block(Key key, int64_t timeoutNs) noexcept
+{
+#ifdef __linux__
+    // FUTEX_WAIT takes a relative timeout on CLOCK_MONOTONIC and returns at once if the word moved on.
+    timespec timeout{};
+    timeout.tv_sec = static_cast<time_t>(timeoutNs / 1'000'000'000);
+    timeout.tv_nsec = static_cast<long>(timeoutNs % 1'000'000'000);
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_epoch), FUTEX_WAIT_PRIVATE, key, timeoutNs < 0 ? nullptr : &timeout, nullptr, 0);
+#else
+    if (timeoutNs < 0)
+    {
+        m_epoch.wait(key, std::memory_order_acquire);
+        return;
+    }
+    std::this_thread::sleep_for(std::min(std::chrono::nanoseconds(timeoutNs), std::chrono::nanoseconds(std::chrono::microseconds(100))));
+#endif
+}
+
+void CEventCount::Wake(bool all) noexcept
+{
+#ifdef __linux__
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_epoch), FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1, nullptr, nullptr, 0);
+#else
+    if (all)
+    {
+        m_epoch.notify_all();
+    }
+    else
+    {
+        m_epoch.notify_one();
+    }
+#endif
+}
@@ -0,0 +1,248 @@
+#include "Utils/Executor.h"
+
+#include "Constants.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+namespace
+{
+    class CFunctionJob : public CExecutorJob
+    {
+    public:
+        explicit CFunctionJob(std::function<void()> task)
+            : m_task(std::move(task))
+        {
+        }
+
+        bool RunSlice() override
+        {
+            m_task();
+            delete this;
+            return false;
+        }
+
+        void Cancel() override { delete this; }
+
+    private:
+        std::function<void()> m_task;
+    };
+
+    // Index of the worker running on this thread in the executor that owns it, if any.
+    thread_local const CExecutor* tlExecutor = nullptr;
+    thread_local size_t tlWorkerIndex = 0;
+} // namespace
+
+CExecutor::CExecutor(size_t workerCount)
+{
+    workerCount = std::max<size_t>(workerCount, 1);
+    m_workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i)
+    {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < workerCount; ++i)
+    {
+        m_workers[i]->m_thread = std::thread(&CExecutor::WorkerLoop, this, i);
+    }
+}
+
+CExecutor::~CExecutor() { Stop(); }
+
+// Store-load pairing with Stop(): either the load here sees m_running cleared, or Stop() sees the
+// count and waits for the push to land before it drains.
+bool CExecutor::EnterAdmission() noexcept
+{
+    m_admitting.fetch_add(1, std::memory_order_seq_cst);
+    if (!m_running.load(std::memory_order_seq_cst))
+    {
+        LeaveAdmission();
+        return false;
+    }
+    return true;
+}
+
+void CExecutor::Schedule(CExecutorJob* job)
+{
+    if (!EnterAdmission())
+    {
+        job->Cancel();
+        return;
+    }
+    if (tlExecutor != this || !m_workers[tlWorkerIndex]->m_deque.Push(job))
+    {
+        m_injection.Push(job);
+    }
+    WakeIdle();
+    LeaveAdmission();
+}
+
+void CExecutor::Defer(CExecutorJob* job)
+{
+    if (!EnterAdmission())
+    {
+        job->Cancel();
+        return;
+    }
+    m_injection.Push(job);
+    WakeIdle();
+    LeaveAdmission();
+}
+
+void CExecutor::Submit(std::function<void()> task) { Schedule(new CFunctionJob(std::move(task))); }
+
+std::optional<size_t> CExecutor::CurrentWorker() const noexcept
+{
+    if (tlExecutor != this)
+    {
+        return std::nullopt;
+    }
+    return tlWorkerIndex;
+}
+
+void CExecutor::Stop()
+{
+    if (!m_running.exchange(false, std::memory_order_seq_cst))
+    {
+        return;
+    }
+    // A job admitted before the flag flipped is queued by the time this returns, so the drain below
+    // sees it; anything later is cancelled by its caller.
+    while (m_admitting.load(std::memory_order_acquire) != 0)
+    {
+        std::this_thread::yield();
+    }
+    {
+        std::lock_guard<std::mutex> lk(m_idleMutex);
+    }
+    m_idleCv.notify_all();
+    for (auto& worker : m_workers)
+    {
+        if (worker->m_thread.joinable())
+        {
+            worker->m_thread.join();
+        }
+    }
+
+    // Workers are gone, so every deque can be drained from here.
+    for (auto& worker : m_workers)
+    {
+        while (std::optional<CExecutorJob*> job = worker->m_deque.Steal())
+        {
+            (*job)->Cancel();
+        }
+        for (CExecutorJob* job : worker->m_nextRound)
+        {
+            job->Cancel();
+        }
+        worker->m_nextRound.clear();
+    }
+    CExecutorJob* job = nullptr;
+    while (m_injection.TryPopValue(job))
+    {
+        job->Cancel();
+    }
+}
+
+void CExecutor::WorkerLoop(size_t index)
+{
+    tlExecutor = this;
+    tlWorkerIndex = index;
+    Worker& self = *m_workers[index];
+    auto roundStart = std::chrono::steady_clock::now();
+
+    while (m_running.load(std::memory_order_acquire))
+    {
+        if (CExecutorJob* job = FindJob(index))
+        {
+            if (job->RunSlice())
+            {
+                self.m_nextRound.push_back(job);
+            }
+            continue;
+        }
+
+        if (self.m_nextRound.empty())
+        {
+            Idle(std::chrono::steady_clock::now() + std::chrono::milliseconds(Constants::executorIdleWaitMs));
+            continue;
+        }
+
+        // Round finished: pace to the tick interval, then requeue this worker's jobs so thieves can
+        // spread them again.
+        Idle(roundStart + std::chrono::milliseconds(Constants::tickIntervalMs));
+        roundStart = std::chrono::steady_clock::now();
+        StartNextRound(self);
+    }
+    tlExecutor = nullptr;
+}
+
+CExecutorJob* CExecutor::FindJob(size_t index)
+{
+    if (std::optional<CExecutorJob*> job = m_workers[index]->m_deque.Pop())
+    {
+        return *job;
+    }
+    CExecutorJob* injected = nullptr;
+    if (m_injection.TryPopValue(injected))
+    {
+        return injected;
+    }
+    for (size_t offset = 1; offset < m_workers.size(); ++offset)
+    {
+        if (std::optional<CExecutorJob*> job = m_workers[(index + offset) % m_workers.size()]->m_deque.Steal())
+        {
+            return *job;
+        }
+    }
+    return nullptr;
+}
+
+void CExecutor::StartNextRound(Worker& worker)
+{
+    for (CExecutorJob* job : worker.m_nextRound)
+    {
+        if (!worker.m_deque.Push(job))
+        {
+            m_injection.Push(job);
+        }
+    }
+    worker.m_nextRound.clear();
+    WakeIdle();
+}
+
+void CExecutor::Idle(std::chrono::steady_clock::time_point deadline)
+{
+    std::unique_lock<std::mutex> lk(m_idleMutex);
+    m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+    m_idleCv.wait_until(lk, deadline, [&] { return !m_running.load(std::memory_order_acquire) || HasQueuedWork(); });
+    m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool CExecutor::HasQueuedWork() const
+{
+    if (!m_injection.Empty())
+    {
+        return true;
+    }
+    return std::any_of(m_workers.begin(), m_workers.end(), [](const auto& worker) { return !worker->m_deque.Empty(); });
+}
+
+void CExecutor::WakeIdle()
+{
+    // RMW pairs with the increment in Idle(); see CEventCount::HasWaiters.
+    if (m_sleepers.fetch_add(0, std::memory_order_seq_cst) != 0)
+    {
+        {
+            std::lock_guard<std::mutex> lk(m_idleMutex);
+        }
+        m_idleCv.notify_all();
+    }
+}
@@ -0,0 +1,145 @@
+#include "Utils/MappedFile.h"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool CMappedFile::Open(const std::string& path)
+{
+#ifdef __linux__
+    Close();
+    int const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    return Map(fd, static_cast<size_t>(info.st_size), false);
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+bool CMappedFile::OpenWritable(const std::string& path, size_t size)
+{
+#ifdef __linux__
+    Close();
+    int const fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    // ftruncate extends with a hole, so an unwritten file costs no disk space or zeroing.
+    if (static_cast<size_t>(info.st_size) < size && ::ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    return Map(fd, std::max(static_cast<size_t>(info.st_size), size), true);
+#else
+    (void)path;
+    (void)size;
+    return false;
+#endif
+}
+
+bool CMappedFile::Map(int fd, size_t size, bool writable)
+{
+#ifdef __linux__
+    if (size > 0)
+    {
+        void* const data = ::mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, writable ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            ::close(fd);
+            return false;
+        }
+        ::madvise(data, size, MADV_SEQUENTIAL);
+        m_data = static_cast<uint8_t*>(data);
+    }
+    m_fd = fd;
+    m_size = size;
+    m_released = 0;
+    m_writable = writable;
+    return true;
+#else
+    (void)fd;
+    (void)size;
+    (void)writable;
+    return false;
+#endif
+}
+
+void CMappedFile::Close()
+{
+#ifdef __linux__
+    if (m_data)
+    {
+        ::munmap(m_data, m_size);
+    }
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+    }
+#endif
+    m_fd = -1;
+    m_data = nullptr;
+    m_size = 0;
+    m_released = 0;
+    m_writable = false;
+}
+
+bool CMappedFile::Sync(size_t offset, size_t length, bool wait) noexcept
+{
+#ifdef __linux__
+    if (!m_data || !m_writable || offset >= m_size)
+    {
+        return m_writable;
+    }
+    // msync wants a page-aligned start.
+    size_t const pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t const begin = offset / pageSize * pageSize;
+    size_t const end = std::min(offset + length, m_size);
+    return ::msync(m_data + begin, end - begin, wait ? MS_SYNC : MS_ASYNC) == 0;
+#else
+    (void)offset;
+    (void)length;
+    (void)wait;
+    return false;
+#endif
+}
+
+void CMappedFile::Release(size_t offset) noexcept
+{
+#ifdef __linux__
+    size_t const pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t const end = std::min(offset, m_size) / pageSize * pageSize;
+    if (!m_data || end <= m_released)
+    {
+        return;
+    }
+    // Only drops the pages from this process: a private read-only mapping has nothing dirty, and a
+    // shared one's writes are already in the page cache, which keeps the data either way.
+    ::madvise(m_data + m_released, end - m_released, MADV_DONTNEED);
+    m_released = end;
+#else
+    (void)offset;
+#endif
+}
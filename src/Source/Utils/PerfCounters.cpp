@@ -0,0 +1,135 @@
+#include "Utils/PerfCounters.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#ifdef __linux__
+    int OpenEvent(uint32_t type, uint64_t config, int groupFd, bool excludeKernel)
+    {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = groupFd < 0 ? 1 : 0;
+        attr.exclude_kernel = excludeKernel ? 1 : 0;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, PERF_FLAG_FD_CLOEXEC));
+    }
+#endif
+} // namespace
+
+bool CPerfCounters::Open()
+{
+#ifdef __linux__
+    if (IsOpen())
+    {
+        return true;
+    }
+    struct EventSpec
+    {
+        uint32_t m_type;
+        uint64_t m_config;
+        bool m_excludeKernel;
+    };
+    // Context switches happen in the kernel, so that event is opened with exclude_kernel off; under a
+    // strict perf_event_paranoid it is simply left out.
+    std::array<EventSpec, COUNTER_COUNT> const specs{{
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, true},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, true},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, true},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, true},
+        {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, false},
+    }};
+    for (size_t counter = 0; counter < COUNTER_COUNT; ++counter)
+    {
+        int const fd = OpenEvent(specs[counter].m_type, specs[counter].m_config, m_leader, specs[counter].m_excludeKernel);
+        if (fd < 0)
+        {
+            continue;
+        }
+        if (m_leader < 0)
+        {
+            m_leader = fd;
+        }
+        m_fds[counter] = fd;
+        m_slots[counter] = static_cast<int>(m_members++);
+    }
+    if (!IsOpen())
+    {
+        return false;
+    }
+    ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void CPerfCounters::Close()
+{
+#ifdef __linux__
+    for (int& fd : m_fds)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        fd = -1;
+    }
+#endif
+    m_slots.fill(-1);
+    m_leader = -1;
+    m_members = 0;
+}
+
+bool CPerfCounters::Read(PerfCounterValues& out) const
+{
+#ifdef __linux__
+    if (!IsOpen())
+    {
+        return false;
+    }
+    // nr, time_enabled, time_running, value[nr]
+    std::array<uint64_t, 3 + COUNTER_COUNT> buffer{};
+    if (read(m_leader, buffer.data(), sizeof(buffer)) < static_cast<ssize_t>((3 + m_members) * sizeof(uint64_t)))
+    {
+        return false;
+    }
+    uint64_t const enabled = buffer[1];
+    uint64_t const running = buffer[2];
+    auto value = [&](Counter counter) -> uint64_t {
+        int const slot = m_slots[counter];
+        if (slot < 0)
+        {
+            return 0;
+        }
+        uint64_t const raw = buffer[3 + static_cast<size_t>(slot)];
+        if (running == 0 || running >= enabled)
+        {
+            return raw;
+        }
+        return static_cast<uint64_t>(static_cast<double>(raw) * static_cast<double>(enabled) / static_cast<double>(running));
+    };
+    out.m_cycles = value(CYCLES);
+    out.m_instructions = value(INSTRUCTIONS);
+    out.m_llcMisses = value(LLC_MISSES);
+    out.m_branchMisses = value(BRANCH_MISSES);
+    out.m_contextSwitches = value(CONTEXT_SWITCHES);
+    return true;
+#else
+    (void)out;
+    return false;
+#endif
+}
@@ -0,0 +1,192 @@
+#include "Utils/ThreadPlacement.h"
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace Utils
+{
+
+    namespace
+    {
+        std::mutex reservedMutex;
+        std::map<int, int> reservedCpus; // CPU to the number of threads holding it
+
+#ifdef __linux__
+        int ToNative(SchedulingPolicy policy)
+        {
+            switch (policy)
+            {
+            case SchedulingPolicy::FIFO:
+                return SCHED_FIFO;
+            case SchedulingPolicy::RR:
+                return SCHED_RR;
+            case SchedulingPolicy::OTHER:
+            default:
+                return SCHED_OTHER;
+            }
+        }
+
+        SchedulingPolicy FromNative(int policy)
+        {
+            switch (policy)
+            {
+            case SCHED_FIFO:
+                return SchedulingPolicy::FIFO;
+            case SCHED_RR:
+                return SchedulingPolicy::RR;
+            default:
+                return SchedulingPolicy::OTHER;
+            }
+        }
+
+        // Affinity of the main thread as the process starts, before any thread pins itself. Threads
+        // inherit their creator's mask, so asking the calling thread instead would return a pinned
+        // thread's own CPUs.
+        cpu_set_t ReadStartupCpus()
+        {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            if (sched_getaffinity(0, sizeof(set), &set) != 0)
+            {
+                CPU_ZERO(&set);
+            }
+            return set;
+        }
+
+        cpu_set_t const startupCpus = ReadStartupCpus();
+#endif
+    } // namespace
+
+    bool SetCurrentThreadName(const std::string& name)
+    {
+#ifdef __linux__
+        // The kernel limit is 16 bytes including the terminator.
+        return pthread_setname_np(pthread_self(), name.substr(0, 15).c_str()) == 0;
+#else
+        (void)name;
+        return false;
+#endif
+    }
+
+    bool SetCurrentThreadAffinity(const std::vector<int>& cpus)
+    {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int const cpu : cpus)
+        {
+            if (cpu >= 0 && cpu < CPU_SETSIZE)
+            {
+                CPU_SET(cpu, &set);
+            }
+        }
+        return CPU_COUNT(&set) > 0 && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        (void)cpus;
+        return false;
+#endif
+    }
+
+    bool SetCurrentThreadScheduling(SchedulingPolicy policy, int priority)
+    {
+#ifdef __linux__
+        // SCHED_OTHER only takes priority 0; anything else is a request that cannot be honoured.
+        if (policy == SchedulingPolicy::OTHER && priority != 0)
+        {
+            return false;
+        }
+        sched_param param{};
+        param.sched_priority = priority;
+        return pthread_setschedparam(pthread_self(), ToNative(policy), &param) == 0;
+#else
+        (void)policy;
+        (void)priority;
+        return false;
+#endif
+    }
+
+    ThreadPlacement GetCurrentThreadPlacement()
+    {
+        ThreadPlacement placement;
+#ifdef __linux__
+        placement.m_cpu = sched_getcpu();
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0)
+        {
+            for (size_t cpu = 0; cpu < placement.m_allowedCpus.size() && cpu < CPU_SETSIZE; ++cpu)
+            {
+                placement.m_allowedCpus.set(cpu, CPU_ISSET(cpu, &set));
+            }
+        }
+        int policy = SCHED_OTHER;
+        sched_param param{};
+        if (pthread_getschedparam(pthread_self(), &policy, &param) == 0)
+        {
+            placement.m_policy = FromNative(policy);
+            placement.m_priority = param.sched_priority;
+        }
+#endif
+        return placement;
+    }
+
+    int GetCurrentCpu()
+    {
+#ifdef __linux__
+        return sched_getcpu();
+#else
+        return -1;
+#endif
+    }
+
+    void ReserveCpus(const std::vector<int>& cpus)
+    {
+        std::lock_guard<std::mutex> lk(reservedMutex);
+        for (int const cpu : cpus)
+        {
+            ++reservedCpus[cpu];
+        }
+    }
+
+    void ReleaseCpus(const std::vector<int>& cpus)
+    {
+        std::lock_guard<std::mutex> lk(reservedMutex);
+        for (int const cpu : cpus)
+        {
+            auto const it = reservedCpus.find(cpu);
+            if (it != reservedCpus.end() && --it->second == 0)
+            {
+                reservedCpus.erase(it);
+            }
+        }
+    }
+
+    std::vector<int> GetUnreservedCpus()
+    {
+        std::vector<int> cpus;
+        std::lock_guard<std::mutex> lk(reservedMutex);
+        if (reservedCpus.empty())
+        {
+            return cpus;
+        }
+#ifdef __linux__
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (CPU_ISSET(cpu, &startupCpus) && reservedCpus.count(cpu) == 0)
+            {
+                cpus.push_back(cpu);
+            }
+        }
+#endif
+        return cpus;
+    }
+
+} // namespace Utils
@@ -0,0 +1,250 @@
+#include "Utils/TimerWheel.h"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+CTimerWheel::CTimerWheel(uint64_t nowNs, uint64_t resolutionNs)
+    : m_resolutionNs(resolutionNs ? resolutionNs : 1)
+    , m_current(nowNs / m_resolutionNs)
+{
+}
+
+CTimerWheel::TimerId CTimerWheel::ScheduleAt(uint64_t deadlineNs, Callback callback)
+{
+    return Add(deadlineNs, 0, std::move(callback));
+}
+
+CTimerWheel::TimerId CTimerWheel::ScheduleEvery(uint64_t firstDeadlineNs, uint64_t periodNs, Callback callback)
+{
+    return Add(firstDeadlineNs, std::max<uint64_t>(periodNs, 1), std::move(callback));
+}
+
+bool CTimerWheel::Cancel(TimerId id)
+{
+    auto const index = static_cast<uint32_t>(id);
+    auto const generation = static_cast<uint32_t>(id >> 32);
+    if (index >= m_timers.size() || !m_timers[index].m_active || m_timers[index].m_generation != generation)
+    {
+        return false;
+    }
+    if (index == m_firing)
+    {
+        // Released by Fire() once the callback returns.
+        m_timers[index].m_active = false;
+        --m_active;
+        return true;
+    }
+    Release(index);
+    return true;
+}
+
+TimerFireStats CTimerWheel::Advance(uint64_t nowNs)
+{
+    TimerFireStats stats;
+    uint64_t const nowTick = nowNs / m_resolutionNs;
+    FireDue(nowNs, stats);
+    for (uint64_t tick = NextEventTick(); tick <= nowTick; tick = NextEventTick())
+    {
+        Process(tick);
+        FireDue(nowNs, stats);
+    }
+    m_current = std::max(m_current, nowTick);
+    return stats;
+}
+
+std::optional<uint64_t> CTimerWheel::NextDeadline() const
+{
+    if (!m_due.empty())
+    {
+        return m_current * m_resolutionNs;
+    }
+    uint64_t const tick = NextEventTick();
+    if (tick == noTick)
+    {
+        return std::nullopt;
+    }
+    return tick * m_resolutionNs;
+}
+
+CTimerWheel::TimerId CTimerWheel::Add(uint64_t deadlineNs, uint64_t periodNs, Callback callback)
+{
+    uint32_t index = 0;
+    if (!m_free.empty())
+    {
+        index = m_free.back();
+        m_free.pop_back();
+    }
+    else
+    {
+        index = static_cast<uint32_t>(m_timers.size());
+        m_timers.emplace_back();
+    }
+    Timer& timer = m_timers[index];
+    timer.m_deadlineNs = deadlineNs;
+    timer.m_periodNs = periodNs;
+    timer.m_callback = std::move(callback);
+    timer.m_active = true;
+    ++m_active;
+    Insert({index, timer.m_generation});
+    return (static_cast<TimerId>(timer.m_generation) << 32) | index;
+}
+
+// A timer goes on the level of the highest 6-bit group in which its expiry tick differs from the
+// current tick, so it is cascaded down exactly when the current tick reaches that group.
+void CTimerWheel::Insert(Entry entry)
+{
+    uint64_t const deadlineNs = m_timers[entry.m_index].m_deadlineNs;
+    uint64_t const expiry = deadlineNs / m_resolutionNs + (deadlineNs % m_resolutionNs != 0 ? 1 : 0);
+    if (expiry <= m_current)
+    {
+        m_due.push_back(entry);
+        return;
+    }
+    auto const level = static_cast<size_t>(std::bit_width(expiry ^ m_current) - 1) / slotBits;
+    if (level >= levelCount)
+    {
+        m_overflow.push_back(entry);
+        return;
+    }
+    size_t const slot = (expiry >> (level * slotBits)) & (slotCount - 1);
+    m_wheel[level][slot].push_back(entry);
+    m_occupied[level] |= uint64_t{1} << slot;
+}
+
+void CTimerWheel::Release(uint32_t index)
+{
+    Timer& timer = m_timers[index];
+    if (timer.m_active)
+    {
+        --m_active;
+    }
+    timer.m_active = false;
+    timer.m_callback = nullptr;
+    ++timer.m_generation;
+    m_free.push_back(index);
+}
+
+void CTimerWheel::Process(uint64_t tick)
+{
+    m_current = tick;
+    if ((tick & ((uint64_t{1} << (levelCount * slotBits)) - 1)) == 0 && !m_overflow.empty())
+    {
+        std::vector<Entry> overflow;
+        overflow.swap(m_overflow);
+        for (Entry const entry : overflow)
+        {
+            Insert(entry);
+        }
+    }
+    for (size_t level = levelCount; level-- > 0;)
+    {
+        if (level > 0 && (tick & ((uint64_t{1} << (level * slotBits)) - 1)) != 0)
+        {
+            continue;
+        }
+        size_t const slot = (tick >> (level * slotBits)) & (slotCount - 1);
+        if ((m_occupied[level] & (uint64_t{1} << slot)) == 0)
+        {
+            continue;
+        }
+        m_occupied[level] &= ~(uint64_t{1} << slot);
+        std::vector<Entry> entries;
+        entries.swap(m_wheel[level][slot]);
+        for (Entry const entry : entries)
+        {
+            Insert(entry);
+        }
+        // Hand the (now empty) buffer back so the slot keeps its capacity.
+        entries.clear();
+        m_wheel[level][slot].swap(entries);
+    }
+}
+
+void CTimerWheel::FireDue(uint64_t nowNs, TimerFireStats& stats)
+{
+    while (!m_due.empty())
+    {
+        std::vector<Entry> due;
+        due.swap(m_due);
+        for (Entry const entry : due)
+        {
+            Fire(entry, nowNs, stats);
+        }
+    }
+}
+
+void CTimerWheel::Fire(Entry entry, uint64_t nowNs, TimerFireStats& stats)
+{
+    Timer& timer = m_timers[entry.m_index];
+    if (!timer.m_active || timer.m_generation != entry.m_generation)
+    {
+        return;
+    }
+    uint64_t const lateness = nowNs > timer.m_deadlineNs ? nowNs - timer.m_deadlineNs : 0;
+    ++stats.m_fired;
+    stats.m_totalLatenessNs += lateness;
+    stats.m_maxLatenessNs = std::max(stats.m_maxLatenessNs, lateness);
+    if (lateness > Constants::timerSlackUs * 1000)
+    {
+        ++stats.m_missed;
+    }
+
+    if (timer.m_periodNs == 0)
+    {
+        Callback callback = std::move(timer.m_callback);
+        Release(entry.m_index);
+        callback();
+        return;
+    }
+
+    uint64_t next = timer.m_deadlineNs + timer.m_periodNs;
+    if (next <= nowNs)
+    {
+        uint64_t const skipped = (nowNs - next) / timer.m_periodNs + 1;
+        stats.m_missed += skipped;
+        next += skipped * timer.m_periodNs;
+    }
+    timer.m_deadlineNs = next;
+    Insert(entry);
+
+    m_firing = entry.m_index;
+    timer.m_callback();
+    m_firing = ~uint32_t{0};
+    if (!timer.m_active)
+    {
+        Release(entry.m_index);
+    }
+}
+
+uint64_t CTimerWheel::NextEventTick() const
+{
+    if (!m_due.empty())
+    {
+        return m_current;
+    }
+    uint64_t best = noTick;
+    for (size_t level = 0; level < levelCount; ++level)
+    {
+        uint64_t const occupied = m_occupied[level];
+        if (occupied == 0)
+        {
+            continue;
+        }
+        size_t const shift = level * slotBits;
+        size_t const current = (m_current >> shift) & (slotCount - 1);
+        uint64_t const ahead = current + 1 < slotCount ? occupied & (~uint64_t{0} << (current + 1)) : 0;
+        uint64_t base = (m_current >> (shift + slotBits)) << (shift + slotBits);
+        if (ahead == 0)
+        {
+            base += uint64_t{1} << (shift + slotBits);
+        }
+        auto const slot = static_cast<uint64_t>(std::countr_zero(ahead != 0 ? ahead : occupied));
+        best = std::min(best, base + (slot << shift));
+    }
+    if (!m_overflow.empty())
+    {
+        best = std::min(best, ((m_current >> (levelCount * slotBits)) + 1) << (levelCount * slotBits));
+    }
+    return best;
+}
@@ -0,0 +1,248 @@
+#include "Utils/Trace.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <jsoncons/json.hpp>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    struct TraceBufferHolder
+    {
+        std::shared_ptr<CTraceBuffer> m_buffer;
+
+        ~TraceBufferHolder()
+        {
+            if (m_buffer)
+            {
+                m_buffer->MarkFinished();
+            }
+        }
+    };
+
+    thread_local TraceBufferHolder tlTraceBuffer;
+
+    struct TraceSession
+    {
+        // Guards the buffer list; never held while a buffer is drained.
+        std::mutex m_buffersMutex;
+        std::vector<std::shared_ptr<CTraceBuffer>> m_buffers;
+        uint32_t m_nextThreadId{1};
+        uint64_t m_retiredDropped{0};
+
+        // Guards the output and flusher state.
+        std::mutex m_outputMutex;
+        std::condition_variable m_wake;
+        std::ofstream m_out;
+        std::thread m_flusher;
+        std::vector<uint32_t> m_announced;
+        bool m_running{false};
+        bool m_firstEvent{true};
+        int m_pid{0};
+    };
+
+    TraceSession& Session()
+    {
+        static TraceSession session;
+        return session;
+    }
+
+    std::string CurrentThreadName()
+    {
+#ifdef __linux__
+        char name[16] = {};
+        if (pthread_getname_np(pthread_self(), name, sizeof(name)) == 0)
+        {
+            return name;
+        }
+#endif
+        return {};
+    }
+
+    // Caller holds m_outputMutex.
+    void WriteEvent(TraceSession& session, jsoncons::json& event)
+    {
+        event["pid"] = session.m_pid;
+        session.m_out << (session.m_firstEvent ? "\n" : ",\n");
+        session.m_firstEvent = false;
+        event.dump(session.m_out);
+    }
+
+    // Caller holds m_outputMutex.
+    void Flush(TraceSession& session)
+    {
+        std::vector<std::shared_ptr<CTraceBuffer>> buffers;
+        {
+            std::lock_guard<std::mutex> lk(session.m_buffersMutex);
+            buffers = session.m_buffers;
+        }
+        for (const auto& buffer : buffers)
+        {
+            bool const finished = buffer->IsFinished();
+            if (std::find(session.m_announced.begin(), session.m_announced.end(), buffer->ThreadId()) == session.m_announced.end())
+            {
+                session.m_announced.push_back(buffer->ThreadId());
+                jsoncons::json meta(jsoncons::json_object_arg);
+                meta["name"] = "thread_name";
+                meta["ph"] = "M";
+                meta["tid"] = buffer->ThreadId();
+                jsoncons::json args(jsoncons::json_object_arg);
+                args["name"] = buffer->ThreadName().empty() ? "thread-" + std::to_string(buffer->ThreadId()) : buffer->ThreadName();
+                meta["args"] = std::move(args);
+                WriteEvent(session, meta);
+            }
+            buffer->Drain([&](const TraceEvent& traced) {
+                jsoncons::json event(jsoncons::json_object_arg);
+                event["name"] = traced.m_name;
+                event["cat"] = "twiz";
+                event["ph"] = std::string(1, traced.m_phase);
+                event["ts"] = static_cast<double>(traced.m_startNs) / 1000.0;
+                if (traced.m_phase == 'X')
+                {
+                    event["dur"] = static_cast<double>(traced.m_durationNs) / 1000.0;
+                }
+                else
+                {
+                    event["s"] = "t";
+                }
+                event["tid"] = buffer->ThreadId();
+                WriteEvent(session, event);
+            });
+            if (finished)
+            {
+                // Drained after the owner exited, so nothing more can arrive.
+                std::lock_guard<std::mutex> lk(session.m_buffersMutex);
+                session.m_retiredDropped += buffer->Dropped();
+                std::erase(session.m_buffers, buffer);
+            }
+        }
+        session.m_out.flush();
+    }
+
+    void FlusherLoop()
+    {
+        TraceSession& session = Session();
+        std::unique_lock<std::mutex> lk(session.m_outputMutex);
+        while (session.m_running)
+        {
+            session.m_wake.wait_for(lk, std::chrono::milliseconds(Constants::traceFlushIntervalMs));
+            Flush(session);
+        }
+    }
+} // namespace
+
+CTraceBuffer::CTraceBuffer(uint32_t threadId, std::string threadName, size_t capacity)
+    : m_mask(std::bit_ceil(capacity ? capacity : 1) - 1)
+    , m_events(std::make_unique<TraceEvent[]>(m_mask + 1))
+    , m_threadId(threadId)
+    , m_threadName(std::move(threadName))
+{
+}
+
+bool CTracer::Start(const std::string& path)
+{
+    TraceSession& session = Session();
+    std::lock_guard<std::mutex> lk(session.m_outputMutex);
+    if (session.m_running)
+    {
+        return false;
+    }
+    session.m_out.open(path, std::ios::out | std::ios::trunc);
+    if (!session.m_out)
+    {
+        return false;
+    }
+#ifdef __linux__
+    session.m_pid = static_cast<int>(getpid());
+#endif
+    session.m_out << "[";
+    session.m_firstEvent = true;
+    session.m_announced.clear();
+    session.m_running = true;
+    session.m_flusher = std::thread(FlusherLoop);
+    s_enabled.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void CTracer::Stop()
+{
+    TraceSession& session = Session();
+    {
+        std::lock_guard<std::mutex> lk(session.m_outputMutex);
+        if (!session.m_running)
+        {
+            return;
+        }
+        s_enabled.store(false, std::memory_order_relaxed);
+        session.m_running = false;
+    }
+    session.m_wake.notify_all();
+    session.m_flusher.join();
+
+    std::lock_guard<std::mutex> lk(session.m_outputMutex);
+    Flush(session);
+    session.m_out << "\n]\n";
+    session.m_out.close();
+}
+
+void CTracer::Complete(const char* name, uint64_t startNs, uint64_t endNs) noexcept
+{
+    if (CTraceBuffer* buffer = LocalBuffer())
+    {
+        buffer->TryPush({name, startNs, endNs > startNs ? endNs - startNs : 0, 'X'});
+    }
+}
+
+void CTracer::Instant(const char* name) noexcept
+{
+    if (CTraceBuffer* buffer = LocalBuffer())
+    {
+        buffer->TryPush({name, Utils::GetTickCountNanos(), 0, 'i'});
+    }
+}
+
+uint64_t CTracer::Dropped()
+{
+    TraceSession& session = Session();
+    std::lock_guard<std::mutex> lk(session.m_buffersMutex);
+    uint64_t dropped = session.m_retiredDropped;
+    for (const auto& buffer : session.m_buffers)
+    {
+        dropped += buffer->Dropped();
+    }
+    return dropped;
+}
+
+CTraceBuffer* CTracer::LocalBuffer()
+{
+    if (!tlTraceBuffer.m_buffer)
+    {
+        try
+        {
+            TraceSession& session = Session();
+            std::lock_guard<std::mutex> lk(session.m_buffersMutex);
+            tlTraceBuffer.m_buffer = std::make_shared<CTraceBuffer>(session.m_nextThreadId++, CurrentThreadName());
+            session.m_buffers.push_back(tlTraceBuffer.m_buffer);
+        }
+        catch (...)
+        {
+            return nullptr;
+        }
+    }
+    return tlTraceBuffer.m_buffer.get();
+}
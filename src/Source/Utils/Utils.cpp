@@ -35,7 +35,7 @@ namespace Utils
 
     uint64_t GetTickCountMillis()
     {
-        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        return GetTickCountNanos() / 1'000'000;
     }
 
     std::string FormatDurationFromMillis(uint64_t milliseconds)